@@ -721,6 +721,7 @@ public:
 	wxObject* Create(IObject *obj, wxObject *parent)
 	{
 		wxArrayString choices (obj->GetPropertyAsArrayString(_("choices")));
+		LimitPreviewItems( &choices );
 		wxCheckListBox *cl =
 			new wxCheckListBox((wxWindow *)parent,-1,
 			obj->GetPropertyAsPoint(_("pos")),
@@ -750,105 +751,165 @@ public:
 
 class GridComponent : public ComponentBase
 {
+private:
+	enum
+	{
+		GRID_POS, GRID_SIZE, GRID_WINDOW_STYLE, GRID_ROWS, GRID_COLS,
+		GRID_DRAG_COL_MOVE, GRID_DRAG_COL_SIZE, GRID_DRAG_GRID_SIZE, GRID_DRAG_ROW_SIZE,
+		GRID_EDITING, GRID_GRID_LINES, GRID_GRID_LINE_COLOR, GRID_MARGIN_WIDTH, GRID_MARGIN_HEIGHT,
+		GRID_COL_LABEL_HORIZ_ALIGNMENT, GRID_COL_LABEL_VERT_ALIGNMENT, GRID_COL_LABEL_SIZE,
+		GRID_COL_LABEL_VALUES, GRID_COLUMN_SIZES,
+		GRID_ROW_LABEL_HORIZ_ALIGNMENT, GRID_ROW_LABEL_VERT_ALIGNMENT, GRID_ROW_LABEL_SIZE,
+		GRID_ROW_LABEL_VALUES, GRID_ROW_SIZES,
+		GRID_LABEL_BG, GRID_LABEL_TEXT, GRID_LABEL_FONT,
+		GRID_CELL_HORIZ_ALIGNMENT, GRID_CELL_VERT_ALIGNMENT, GRID_CELL_BG, GRID_CELL_TEXT, GRID_CELL_FONT,
+		GRID_AUTOSIZE_ROWS, GRID_AUTOSIZE_COLS
+	};
+
+	PropertyHandles m_props;
+
+	static const wxChar* const* PropertyNames()
+	{
+		static const wxChar* const names[] =
+		{
+			wxT("pos"), wxT("size"), wxT("window_style"), wxT("rows"), wxT("cols"),
+			wxT("drag_col_move"), wxT("drag_col_size"), wxT("drag_grid_size"), wxT("drag_row_size"),
+			wxT("editing"), wxT("grid_lines"), wxT("grid_line_color"), wxT("margin_width"), wxT("margin_height"),
+			wxT("col_label_horiz_alignment"), wxT("col_label_vert_alignment"), wxT("col_label_size"),
+			wxT("col_label_values"), wxT("column_sizes"),
+			wxT("row_label_horiz_alignment"), wxT("row_label_vert_alignment"), wxT("row_label_size"),
+			wxT("row_label_values"), wxT("row_sizes"),
+			wxT("label_bg"), wxT("label_text"), wxT("label_font"),
+			wxT("cell_horiz_alignment"), wxT("cell_vert_alignment"), wxT("cell_bg"), wxT("cell_text"), wxT("cell_font"),
+			wxT("autosize_rows"), wxT("autosize_cols"),
+			NULL
+		};
+		return names;
+	}
+
 public:
+	GridComponent()
+	:
+	m_props( PropertyNames() )
+	{
+	}
 
 	wxObject* Create(IObject *obj, wxObject *parent)
 	{
+		// Resolve the handles once and read the plain values in one call
+		std::vector< PropertyValue > values;
+		m_props.GetValues( obj, &values );
+
 		wxGrid *grid = new wxGrid((wxWindow *)parent,-1,
-			obj->GetPropertyAsPoint(_("pos")),
-			obj->GetPropertyAsSize(_("size")),
-			obj->GetPropertyAsInteger(_("window_style")));
+			obj->GetPropertyAsPoint(m_props[GRID_POS]),
+			obj->GetPropertyAsSize(m_props[GRID_SIZE]),
+			values[GRID_WINDOW_STYLE].integer);
+
+		// Only a preview of huge grids is created, with an extra "+N more" row/column
+		int rows = values[GRID_ROWS].integer;
+		int cols = values[GRID_COLS].integer;
+		int shownRows = GetPreviewCount( rows );
+		int shownCols = GetPreviewCount( cols );
 
 		grid->CreateGrid(
-			obj->GetPropertyAsInteger(_("rows")),
-			obj->GetPropertyAsInteger(_("cols")));
+			shownRows + ( shownRows < rows ? 1 : 0 ),
+			shownCols + ( shownCols < cols ? 1 : 0 ) );
 
-		grid->EnableDragColMove( obj->GetPropertyAsInteger( _("drag_col_move") ) != 0 );
-		grid->EnableDragColSize( obj->GetPropertyAsInteger( _("drag_col_size") ) != 0 );
-		grid->EnableDragGridSize( obj->GetPropertyAsInteger( _("drag_grid_size") ) != 0 );
-		grid->EnableDragRowSize( obj->GetPropertyAsInteger( _("drag_row_size") ) != 0 );
-		grid->EnableEditing( obj->GetPropertyAsInteger( _("editing") ) != 0 );
-		grid->EnableGridLines( obj->GetPropertyAsInteger( _("grid_lines") ) != 0 );
-		if ( !obj->IsNull( _("grid_line_color") ) )
+		grid->EnableDragColMove( values[GRID_DRAG_COL_MOVE].integer != 0 );
+		grid->EnableDragColSize( values[GRID_DRAG_COL_SIZE].integer != 0 );
+		grid->EnableDragGridSize( values[GRID_DRAG_GRID_SIZE].integer != 0 );
+		grid->EnableDragRowSize( values[GRID_DRAG_ROW_SIZE].integer != 0 );
+		grid->EnableEditing( values[GRID_EDITING].integer != 0 );
+		grid->EnableGridLines( values[GRID_GRID_LINES].integer != 0 );
+		if ( !values[GRID_GRID_LINE_COLOR].isNull )
 		{
-			grid->SetGridLineColour( obj->GetPropertyAsColour( _("grid_line_color") ) );
+			grid->SetGridLineColour( obj->GetPropertyAsColour( m_props[GRID_GRID_LINE_COLOR] ) );
 		}
-		grid->SetMargins( obj->GetPropertyAsInteger( _("margin_width") ), obj->GetPropertyAsInteger( _("margin_height") ) );
+		grid->SetMargins( values[GRID_MARGIN_WIDTH].integer, values[GRID_MARGIN_HEIGHT].integer );
 
 		// Label Properties
-		grid->SetColLabelAlignment( obj->GetPropertyAsInteger( _("col_label_horiz_alignment") ), obj->GetPropertyAsInteger( _("col_label_vert_alignment") ) );
-		grid->SetColLabelSize( obj->GetPropertyAsInteger( _("col_label_size") ) );
+		grid->SetColLabelAlignment( values[GRID_COL_LABEL_HORIZ_ALIGNMENT].integer, values[GRID_COL_LABEL_VERT_ALIGNMENT].integer );
+		grid->SetColLabelSize( values[GRID_COL_LABEL_SIZE].integer );
 
-		wxArrayString columnLabels = obj->GetPropertyAsArrayString( _("col_label_values") );
-		for ( int i = 0; i < (int)columnLabels.size() && i < grid->GetNumberCols(); ++i )
+		wxArrayString columnLabels = obj->GetPropertyAsArrayString( m_props[GRID_COL_LABEL_VALUES] );
+		for ( int i = 0; i < (int)columnLabels.size() && i < shownCols; ++i )
 		{
 			grid->SetColLabelValue( i, columnLabels[i] );
 		}
 
-		wxArrayInt columnSizes = obj->GetPropertyAsArrayInt( _("column_sizes") );
-		for ( int i = 0; i < (int)columnSizes.size() && i < grid->GetNumberCols(); ++i )
+		wxArrayInt columnSizes = obj->GetPropertyAsArrayInt( m_props[GRID_COLUMN_SIZES] );
+		for ( int i = 0; i < (int)columnSizes.size() && i < shownCols; ++i )
 		{
 			grid->SetColSize( i, columnSizes[i] );
 		}
 
-		grid->SetRowLabelAlignment( obj->GetPropertyAsInteger( _("row_label_horiz_alignment") ), obj->GetPropertyAsInteger( _("row_label_vert_alignment") ) );
-		grid->SetRowLabelSize( obj->GetPropertyAsInteger( _("row_label_size") ) );
+		grid->SetRowLabelAlignment( values[GRID_ROW_LABEL_HORIZ_ALIGNMENT].integer, values[GRID_ROW_LABEL_VERT_ALIGNMENT].integer );
+		grid->SetRowLabelSize( values[GRID_ROW_LABEL_SIZE].integer );
 
-		wxArrayString rowLabels = obj->GetPropertyAsArrayString( _("row_label_values") );
-		for ( int i = 0; i < (int)rowLabels.size() && i < grid->GetNumberRows(); ++i )
+		wxArrayString rowLabels = obj->GetPropertyAsArrayString( m_props[GRID_ROW_LABEL_VALUES] );
+		for ( int i = 0; i < (int)rowLabels.size() && i < shownRows; ++i )
 		{
 			grid->SetRowLabelValue( i, rowLabels[i] );
 		}
 
-		wxArrayInt rowSizes = obj->GetPropertyAsArrayInt( _("row_sizes") );
-		for ( int i = 0; i < (int)rowSizes.size() && i < grid->GetNumberRows(); ++i )
+		wxArrayInt rowSizes = obj->GetPropertyAsArrayInt( m_props[GRID_ROW_SIZES] );
+		for ( int i = 0; i < (int)rowSizes.size() && i < shownRows; ++i )
 		{
 			grid->SetRowSize( i, rowSizes[i] );
 		}
 
-		if ( !obj->IsNull( _("label_bg") ) )
+		if ( !values[GRID_LABEL_BG].isNull )
 		{
-			grid->SetLabelBackgroundColour( obj->GetPropertyAsColour( _("label_bg") ) );
+			grid->SetLabelBackgroundColour( obj->GetPropertyAsColour( m_props[GRID_LABEL_BG] ) );
 		}
-		if ( !obj->IsNull( _("label_text") ) )
+		if ( !values[GRID_LABEL_TEXT].isNull )
 		{
-			grid->SetLabelTextColour( obj->GetPropertyAsColour( _("label_text") ) );
+			grid->SetLabelTextColour( obj->GetPropertyAsColour( m_props[GRID_LABEL_TEXT] ) );
 		}
-		if ( !obj->IsNull( _("label_font") ) )
+		if ( !values[GRID_LABEL_FONT].isNull )
 		{
-			grid->SetLabelFont( obj->GetPropertyAsFont( _("label_font") ) );
+			grid->SetLabelFont( obj->GetPropertyAsFont( m_props[GRID_LABEL_FONT] ) );
 		}
 
 		// Default Cell Properties
-		grid->SetDefaultCellAlignment( obj->GetPropertyAsInteger( _("cell_horiz_alignment") ), obj->GetPropertyAsInteger( _("cell_vert_alignment") ) );
+		grid->SetDefaultCellAlignment( values[GRID_CELL_HORIZ_ALIGNMENT].integer, values[GRID_CELL_VERT_ALIGNMENT].integer );
 
-		if ( !obj->IsNull( _("cell_bg") ) )
+		if ( !values[GRID_CELL_BG].isNull )
+		{
+			grid->SetDefaultCellBackgroundColour( obj->GetPropertyAsColour( m_props[GRID_CELL_BG] ) );
+		}
+		if ( !values[GRID_CELL_TEXT].isNull )
+		{
+			grid->SetDefaultCellTextColour( obj->GetPropertyAsColour( m_props[GRID_CELL_TEXT] ) );
+		}
+		if ( !values[GRID_CELL_FONT].isNull )
 		{
-			grid->SetDefaultCellBackgroundColour( obj->GetPropertyAsColour( _("cell_bg") ) );
+			grid->SetDefaultCellFont( obj->GetPropertyAsFont( m_props[GRID_CELL_FONT] ) );
 		}
-		if ( !obj->IsNull( _("cell_text") ) )
+
+		if ( shownRows < rows )
 		{
-			grid->SetDefaultCellTextColour( obj->GetPropertyAsColour( _("cell_text") ) );
+			grid->SetRowLabelValue( shownRows, GetPreviewMoreLabel( rows - shownRows ) );
 		}
-		if ( !obj->IsNull( _("cell_font") ) )
+		if ( shownCols < cols )
 		{
-			grid->SetDefaultCellFont( obj->GetPropertyAsFont( _("cell_font") ) );
+			grid->SetColLabelValue( shownCols, GetPreviewMoreLabel( cols - shownCols ) );
 		}
 
 		// Example Cell Values
-		for ( int col = 0; col < grid->GetNumberCols(); ++col )
+		for ( int col = 0; col < shownCols; ++col )
 		{
-			for ( int row = 0; row < grid->GetNumberRows(); ++row )
+			for ( int row = 0; row < shownRows; ++row )
 			{
 				grid->SetCellValue( row, col, grid->GetColLabelValue( col ) + wxT("-") + grid->GetRowLabelValue( row ) );
 			}
 		}
 
-		if ( obj->GetPropertyAsInteger( _("autosize_rows") ) != 0 )
+		if ( values[GRID_AUTOSIZE_ROWS].integer != 0 )
 		{
 			grid->AutoSizeRows();
 		}
-		if ( obj->GetPropertyAsInteger( _("autosize_cols") ) != 0 )
+		if ( values[GRID_AUTOSIZE_COLS].integer != 0 )
 		{
 			grid->AutoSizeColumns();
 		}
@@ -414,11 +414,12 @@ public:
 
 		// choices
 		wxArrayString choices = obj->GetPropertyAsArrayString(_("choices"));
+		int shown = LimitPreviewItems( &choices );
 		for (unsigned int i=0; i<choices.GetCount(); i++)
 			combo->Append(choices[i]);
 
 		int sel = obj->GetPropertyAsInteger(_("selection"));
-		if( sel > -1 && sel < (int) choices.GetCount() ) combo->SetSelection(sel);
+		if( sel > -1 && sel < shown ) combo->SetSelection(sel);
 
 		combo->PushEventHandler( new ComponentEvtHandler( combo, GetManager() ) );
 
@@ -459,14 +460,20 @@ public:
 
 		// choices
 		wxArrayString choices = obj->GetPropertyAsArrayString(_("choices"));
-		for (unsigned int i=0; i<choices.GetCount(); i++)
+		int count = (int)choices.GetCount();
+		int shown = GetPreviewCount( count );
+		for (int i=0; i<shown; i++)
 		{
 			wxImage img(choices[i].BeforeFirst(wxChar(58)));
 			bcombo->Append(choices[i].AfterFirst(wxChar(58)), wxBitmap(img));
 		}
+		if ( shown < count )
+		{
+			bcombo->Append( GetPreviewMoreLabel( count - shown ) );
+		}
 
 		int sel = obj->GetPropertyAsInteger(_("selection"));
-		if( sel > -1 && sel < (int) choices.GetCount() ) bcombo->SetSelection(sel);
+		if( sel > -1 && sel < shown ) bcombo->SetSelection(sel);
 
 		bcombo->PushEventHandler( new ComponentEvtHandler( bcombo, GetManager() ) );
 
@@ -669,6 +676,7 @@ public:
 
 		// choices
 		wxArrayString choices = obj->GetPropertyAsArrayString(_("choices"));
+		LimitPreviewItems( &choices );
 		for (unsigned int i=0; i<choices.Count(); i++)
 			listbox->Append(choices[i]);
 
@@ -1407,6 +1415,7 @@ public:
 	wxObject* Create(IObject *obj, wxObject *parent)
 	{
 		wxArrayString choices = obj->GetPropertyAsArrayString(_("choices"));
+		int shown = LimitPreviewItems( &choices );
 		wxString *strings = new wxString[choices.GetCount()];
 		for (unsigned int i=0; i < choices.GetCount(); i++)
 			strings[i] = choices[i];
@@ -1419,7 +1428,7 @@ public:
 			obj->GetPropertyAsInteger(_("window_style")));
 
 		int sel = obj->GetPropertyAsInteger(_("selection"));
-		if( sel < (int) choices.GetCount() ) choice->SetSelection(sel);
+		if( sel < shown ) choice->SetSelection(sel);
 
 		delete []strings;
 
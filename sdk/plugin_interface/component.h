@@ -59,6 +59,33 @@ enum
 };
 
 
+// Handle to a property of an object, returned by IObject::GetPropertyHandle.
+// All objects of the same class share the same handles, so a component can
+// resolve the names once and reuse the handles for every object it creates.
+class PropertyHandle
+{
+ public:
+  explicit PropertyHandle( int index = -1 ) : m_index( index ) {}
+  bool IsOk() const { return m_index >= 0; }
+  int  GetIndex() const { return m_index; }
+
+ private:
+  int m_index;
+};
+
+// Typed copy of a property value, filled by IObject::GetPropertyValues.
+// The raw value is always stored in 'text'; 'integer' is set for integer,
+// boolean, option, macro and bitlist properties and 'number' for float ones.
+struct PropertyValue
+{
+  PropertyValue() : isNull( true ), integer( 0 ), number( 0 ) {}
+
+  bool     isNull;
+  int      integer;
+  double   number;
+  wxString text;
+};
+
 // Plugins interface
 // The point is to provide an interface for accessing the object's properties
 // from the plugin itself, in a safe way.
@@ -82,6 +109,26 @@ class IObject
   virtual unsigned int  GetChildCount() = 0;
   virtual wxString GetObjectTypeName() = 0;
   virtual IObject* GetChildPtr (unsigned int idx) = 0;
+
+  // Pre-resolved property access, see PropertyHandle
+  virtual PropertyHandle GetPropertyHandle( const wxString& pname ) = 0;
+  virtual bool     IsNull (const PropertyHandle& handle) = 0;
+  virtual int      GetPropertyAsInteger (const PropertyHandle& handle) = 0;
+  virtual bool     GetPropertyAsBoolean(const PropertyHandle& handle) = 0;
+  virtual wxFontContainer   GetPropertyAsFont    (const PropertyHandle& handle) = 0;
+  virtual wxColour GetPropertyAsColour  (const PropertyHandle& handle) = 0;
+  virtual wxString GetPropertyAsString  (const PropertyHandle& handle) = 0;
+  virtual wxPoint  GetPropertyAsPoint   (const PropertyHandle& handle) = 0;
+  virtual wxSize   GetPropertyAsSize    (const PropertyHandle& handle) = 0;
+  virtual wxBitmap GetPropertyAsBitmap  (const PropertyHandle& handle) = 0;
+  virtual wxArrayInt GetPropertyAsArrayInt(const PropertyHandle& handle) = 0;
+  virtual wxArrayString GetPropertyAsArrayString(const PropertyHandle& handle) = 0;
+  virtual double GetPropertyAsFloat(const PropertyHandle& handle) = 0;
+
+  // Fills 'values' with the typed values of 'count' properties in one call.
+  // Invalid handles leave the default (null) value.
+  virtual void GetPropertyValues( const PropertyHandle* handles, unsigned int count, PropertyValue* values ) = 0;
+
   virtual ~IObject(){}
 };
 
@@ -214,6 +261,12 @@ public:
 	*/
 	virtual bool SelectObject( wxObject* wxobject ) = 0;
 
+	/**
+	Get the maximum number of rows, columns or items a widget should create in the designer.
+	The generated code always uses the real values. 0 means no limit.
+	*/
+	virtual unsigned int GetPreviewLimit() = 0;
+
 	virtual ~IManager(){}
 };
 
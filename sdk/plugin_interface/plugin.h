@@ -175,6 +175,62 @@ class ComponentLibrary : public IComponentLibrary
   }*/
 };
 
+/**
+ * Property handles of a component, resolved from a NULL terminated list of
+ * property names the first time an object is created and reused afterwards.
+ * The handles are resolved again when the component is used with another class.
+ */
+class PropertyHandles
+{
+private:
+	std::vector< wxString > m_names;
+	std::vector< PropertyHandle > m_handles;
+	wxString m_class;
+
+public:
+	PropertyHandles( const wxChar* const* names )
+	{
+		for ( ; *names != NULL; ++names )
+		{
+			m_names.push_back( *names );
+		}
+		m_handles.resize( m_names.size() );
+	}
+
+	void Resolve( IObject* obj )
+	{
+		wxString className = obj->GetClassName();
+		if ( className == m_class )
+		{
+			return;
+		}
+
+		for ( size_t i = 0; i < m_names.size(); ++i )
+		{
+			m_handles[i] = obj->GetPropertyHandle( m_names[i] );
+		}
+		m_class = className;
+	}
+
+	/**
+	 * Resolves the handles if needed and reads all the values in one call.
+	 */
+	void GetValues( IObject* obj, std::vector< PropertyValue >* values )
+	{
+		Resolve( obj );
+		values->assign( m_handles.size(), PropertyValue() );
+		if ( !m_handles.empty() )
+		{
+			obj->GetPropertyValues( &m_handles[0], (unsigned int)m_handles.size(), &(*values)[0] );
+		}
+	}
+
+	const PropertyHandle& operator[]( size_t idx ) const
+	{
+		return m_handles[idx];
+	}
+};
+
 /**
  * Base class for components
  */
@@ -206,6 +262,44 @@ public:
 		return m_manager;
 	}
 
+	/**
+	 * Number of rows or columns to create in the designer out of 'count',
+	 * honoring the preview limit of the project.
+	 */
+	int GetPreviewCount( int count )
+	{
+		unsigned int limit = ( m_manager != NULL ? m_manager->GetPreviewLimit() : 0 );
+		if ( limit > 0 && count > (int)limit )
+		{
+			return (int)limit;
+		}
+		return count;
+	}
+
+	/**
+	 * Label of the indicator which replaces the 'hidden' items not created in the designer.
+	 */
+	static wxString GetPreviewMoreLabel( int hidden )
+	{
+		return wxString::Format( _("+%i more"), hidden );
+	}
+
+	/**
+	 * Drops the items over the preview limit of the project, appending a "+N more"
+	 * item in their place. Returns the number of real items kept.
+	 */
+	int LimitPreviewItems( wxArrayString* items )
+	{
+		int count = (int)items->GetCount();
+		int shown = GetPreviewCount( count );
+		if ( shown < count )
+		{
+			items->RemoveAt( shown, count - shown );
+			items->Add( GetPreviewMoreLabel( count - shown ) );
+		}
+		return shown;
+	}
+
 	wxObject* Create( IObject* /*obj*/, wxObject* /*parent*/ )
 	{
 		return m_manager->NewNoObject(); /* Even components which are not visible must be unique in the map */
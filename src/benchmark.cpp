@@ -0,0 +1,900 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+
+#include "rad/appdata.h"
+#include "model/objectbase.h"
+#include "model/database.h"
+#include "model/xrcfilter.h"
+#include "codegen/codewriter.h"
+#include "codegen/codeparser.h"
+#include "codegen/cppcg.h"
+#include "codegen/pythoncg.h"
+#include "codegen/luacg.h"
+#include "codegen/phpcg.h"
+#include "codegen/xrccg.h"
+#include "utils/wxfbexception.h"
+#include "utils/stringutils.h"
+#include "utils/typeconv.h"
+#include "utils/debug.h"
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+#include <wx/utils.h>
+
+#include <ticpp.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#ifdef __LINUX__
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+// Small image embedded by the bitmap widgets
+static const char s_xpm[] =
+	"/* XPM */\n"
+	"static const char* benchmark_xpm[] = {\n"
+	"\"4 4 2 1\",\n"
+	"\"  c None\",\n"
+	"\". c #000000\",\n"
+	"\".. .\",\n"
+	"\". ..\",\n"
+	"\".. .\",\n"
+	"\". ..\"};\n";
+
+// Widgets added to the forms, in turn
+static const char* const s_widgets[] =
+{
+	"wxButton",
+	"wxStaticText",
+	"wxTextCtrl",
+	"wxCheckBox",
+	"wxChoice",
+	"wxStaticBitmap",
+};
+
+// Resident memory of the process in KB, -1 if it is not known on this platform
+static long GetResidentMemory()
+{
+#ifdef __LINUX__
+	FILE* statm = fopen( "/proc/self/statm", "r" );
+	if ( NULL == statm )
+	{
+		return -1;
+	}
+
+	long size = 0;
+	long resident = -1;
+	if ( fscanf( statm, "%ld %ld", &size, &resident ) != 2 )
+	{
+		resident = -1;
+	}
+	fclose( statm );
+
+	return ( resident < 0 ? -1 : resident * ( sysconf( _SC_PAGESIZE ) / 1024 ) );
+#else
+	return -1;
+#endif
+}
+
+// Highest resident memory of the process so far in KB, -1 if it is not known
+static long GetPeakResidentMemory()
+{
+#ifdef __LINUX__
+	struct rusage usage;
+	if ( getrusage( RUSAGE_SELF, &usage ) != 0 )
+	{
+		return -1;
+	}
+	return usage.ru_maxrss;
+#else
+	return -1;
+#endif
+}
+
+// The per-character conversion EscapeString replaced, used as its reference
+static wxString EscapeStringReference( const wxString& str, bool escapeQuotes )
+{
+	wxString result;
+
+	for ( size_t i = 0; i < str.length(); i++ )
+	{
+		wxChar c = str[i];
+
+		switch ( c )
+		{
+		case wxT('"'):
+			result += ( escapeQuotes ? wxT("\\\"") : wxT("\"") );
+			break;
+
+		case wxT('\\'):
+			result += wxT("\\\\");
+			break;
+
+		case wxT('\t'):
+			result += wxT("\\t");
+			break;
+
+		case wxT('\n'):
+			result += wxT("\\n");
+			break;
+
+		case wxT('\r'):
+			result += wxT("\\r");
+			break;
+
+		default:
+			result += c;
+			break;
+		}
+	}
+	return result;
+}
+
+Benchmark::Benchmark( const Options& options )
+:
+m_options( options ),
+m_objDb( AppData()->GetObjectDatabase() ),
+m_count( 0 ),
+m_rssBeforeLoad( -1 ),
+m_rssAfterLoad( -1 ),
+m_rssPeak( -1 )
+{
+	m_options.iterations = std::max( m_options.iterations, 1u );
+	m_pool.values = m_pool.references = m_pool.chars = 0;
+}
+
+PObjectBase Benchmark::Add( const char* className, PObjectBase parent )
+{
+	PObjectBase obj = m_objDb->CreateObject( className, parent );
+	if ( !obj )
+	{
+		THROW_WXFBEX( wxT("Unable to create a ") << wxString::FromAscii( className ) << wxT(" in a ") << parent->GetClassName() )
+	}
+
+	if ( parent )
+	{
+		parent->AddChild( obj );
+		obj->SetParent( parent );
+	}
+
+	// Skip the sizer items and pages the database wraps the object with
+	while ( obj->GetObjectInfo()->GetObjectType()->IsItem() && obj->GetChildCount() > 0 )
+	{
+		obj = obj->GetChild( 0 );
+	}
+
+	PProperty name = obj->GetProperty( wxT("name") );
+	if ( name )
+	{
+		name->SetValue( wxString::Format( wxT("%s%u"), wxString::FromAscii( className ).c_str(), ++m_count ) );
+	}
+
+	return obj;
+}
+
+PObjectBase Benchmark::CreateForm( PObjectBase project, unsigned int index )
+{
+	PObjectBase form = Add( "Frame", project );
+	form->GetProperty( wxT("name") )->SetValue( wxString::Format( wxT("BenchmarkFrame%u"), index ) );
+
+	PObjectBase menuBar = Add( "wxMenuBar", form );
+	for ( unsigned int m = 0; m < 3; ++m )
+	{
+		PObjectBase menu = Add( "wxMenu", menuBar );
+		for ( unsigned int i = 0; i < 5; ++i )
+		{
+			Add( "wxMenuItem", menu );
+		}
+	}
+
+	PObjectBase sizer = Add( "wxBoxSizer", form );
+	for ( unsigned int d = 0; d < m_options.depth; ++d )
+	{
+		sizer = Add( "wxBoxSizer", sizer );
+	}
+
+	PObjectBase notebook = Add( "wxNotebook", sizer );
+	PObjectBase page = Add( "wxPanel", notebook );
+	PObjectBase pageSizer = Add( "wxBoxSizer", page );
+	Add( "wxGrid", pageSizer );
+
+	// Half of the widgets in the deepest sizer, the other half in the notebook page
+	for ( unsigned int w = 0; w < m_options.widgets; ++w )
+	{
+		const char* className = s_widgets[ w % ( sizeof( s_widgets ) / sizeof( s_widgets[0] ) ) ];
+		PObjectBase widget = Add( className, ( w % 2 == 0 ? sizer : pageSizer ) );
+
+		PProperty bitmap = widget->GetProperty( wxT("bitmap") );
+		if ( bitmap )
+		{
+			bitmap->SetValue( wxT("Load From Embedded File; ") + m_bitmap );
+		}
+	}
+
+	return form;
+}
+
+PObjectBase Benchmark::CreateProject()
+{
+	PObjectBase project = m_objDb->CreateObject( "Project" );
+	project->GetProperty( wxT("name") )->SetValue( wxT("benchmark") );
+	project->GetProperty( wxT("file") )->SetValue( wxT("benchmark") );
+
+	for ( unsigned int f = 0; f < m_options.forms; ++f )
+	{
+		CreateForm( project, f );
+	}
+
+	return project;
+}
+
+void Benchmark::Time( const wxString& name, std::function< void() > operation )
+{
+	Result result;
+	result.name = name;
+
+	for ( unsigned int i = 0; i < m_options.iterations; ++i )
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		operation();
+		std::chrono::duration< double, std::milli > elapsed = std::chrono::steady_clock::now() - start;
+		result.times.push_back( elapsed.count() );
+	}
+
+	wxLogMessage( wxT("%s: %.2f ms"), name.c_str(), *std::min_element( result.times.begin(), result.times.end() ) );
+	m_results.push_back( result );
+}
+
+void Benchmark::CheckEscapeString()
+{
+	wxString alphabet = wxT("aZ 0_\"\\\n\t\r");
+#if wxUSE_UNICODE
+	alphabet += wxChar( 0xE9 );
+	alphabet += wxChar( 0x20AC );
+#endif
+
+	// Labels, tooltips and help strings: mostly clean, some of them multi-line or quoted
+	std::vector< wxString > texts;
+	texts.push_back( wxEmptyString );
+	texts.push_back( wxT("\"\\\n\t\r") );
+	unsigned long seed = 1;
+	size_t chars = 0;
+	for ( unsigned int i = 0; i < 20000; ++i )
+	{
+		seed = seed * 1103515245 + 12345;
+		size_t length = ( seed >> 16 ) % 200;
+		bool clean = ( i % 4 != 0 );
+
+		wxString text;
+		for ( size_t c = 0; c < length; ++c )
+		{
+			seed = seed * 1103515245 + 12345;
+			size_t index = ( seed >> 16 ) % alphabet.length();
+
+			// The characters to escape are at 5 to 9
+			if ( clean && index >= 5 && index < 10 )
+			{
+				text += wxT('x');
+			}
+			else
+			{
+				text += alphabet.GetChar( index );
+			}
+		}
+		texts.push_back( text );
+		chars += text.length();
+	}
+
+	for ( size_t i = 0; i < texts.size(); ++i )
+	{
+		for ( int quotes = 0; quotes < 2; ++quotes )
+		{
+			if ( TypeConv::EscapeString( texts[i], quotes != 0 ) != EscapeStringReference( texts[i], quotes != 0 ) )
+			{
+				THROW_WXFBEX( wxT("EscapeString differs from the per-character conversion for \"") << texts[i] << wxT("\"") )
+			}
+		}
+
+		if ( TypeConv::StringToText( texts[i] ) != EscapeStringReference( texts[i], false ) )
+		{
+			THROW_WXFBEX( wxT("StringToText differs from the per-character conversion for \"") << texts[i] << wxT("\"") )
+		}
+	}
+
+	if ( TypeConv::EscapeString( wxT("Clean text"), true ) != wxT("Clean text") || TypeConv::StringToText( wxT("\"quoted\"") ) != wxT("\"quoted\"") )
+	{
+		THROW_WXFBEX( wxT("EscapeString changes text without anything to escape") )
+	}
+
+	Time( wxT("EscapeString"), [&]()
+	{
+		size_t escaped = 0;
+		for ( size_t i = 0; i < texts.size(); ++i )
+		{
+			escaped += TypeConv::EscapeString( texts[i], true ).length();
+		}
+		LogDebug( wxT("%lu characters escaped to %lu"), (unsigned long)chars, (unsigned long)escaped );
+	} );
+
+	Time( wxT("EscapeStringReference"), [&]()
+	{
+		size_t escaped = 0;
+		for ( size_t i = 0; i < texts.size(); ++i )
+		{
+			escaped += EscapeStringReference( texts[i], true ).length();
+		}
+		LogDebug( wxT("%lu characters escaped to %lu"), (unsigned long)chars, (unsigned long)escaped );
+	} );
+}
+
+void Benchmark::CheckCodeParser()
+{
+	const unsigned int functions = 3000;
+	wxString header = m_dir + wxT("BenchmarkClass.h");
+	wxString source = m_dir + wxT("BenchmarkClass.cpp");
+
+	wxString headerCode = wxT("#include \"benchmark.h\"\n\n/** Implementing BenchmarkBase */\nclass BenchmarkClass : public BenchmarkBase\n{\n")
+		wxT("//// end generated class members\nint m_count; // { not a brace\n};\n");
+
+	// Braces in comments and literals which the parser must not count
+	std::vector< wxString > headings;
+	std::vector< wxString > bodies;
+	wxString sourceCode = wxT("#include \"BenchmarkClass.h\"\n\nint BenchmarkClass::s_count = 0;\n");
+	for ( unsigned int i = 0; i < functions; ++i )
+	{
+		wxString heading = wxString::Format( wxT("void BenchmarkClass::OnEvent%u( wxCommandEvent& event )"), i );
+		wxString body = wxString::Format( wxT("\t// a { in a comment\n\tint value = %u; /* } */\n\tconst char* text = \"}{\\\"}\";\n\tchar open = '{';\n")
+			wxT("\tif ( value > 0 )\n\t{\n\t\tvalue += text[0] + open;\n\t}\n\twxUnusedVar( event );"), i );
+
+		sourceCode << wxString::Format( wxT("\n/* OnEvent%u { */\n"), i ) << heading << wxT("\n{\n") << body << wxT("\n}\n");
+		headings.push_back( heading );
+		bodies.push_back( body );
+	}
+
+	// The last function is missing its closing bracket
+	wxString broken = wxT("void BenchmarkClass::Broken()\n{\n\tif ( s_count )\n\t{\n\t\ts_count = 0;\n\t}\n");
+	wxString sources[] = { sourceCode, sourceCode + broken };
+
+	// The files are removed even if a check fails
+	try
+	{
+		wxFFile headerFile( header, wxT("wb") );
+		if ( !headerFile.IsOpened() || !headerFile.Write( headerCode ) )
+		{
+			THROW_WXFBEX( wxT("Unable to write ") << header )
+		}
+		headerFile.Close();
+
+		for ( size_t s = 0; s < WXSIZEOF( sources ); ++s )
+		{
+			wxFFile sourceFile( source, wxT("wb") );
+			if ( !sourceFile.IsOpened() || !sourceFile.Write( sources[s] ) )
+			{
+				THROW_WXFBEX( wxT("Unable to write ") << source )
+			}
+			sourceFile.Close();
+
+			std::unique_ptr< CCodeParser > parser;
+			Time( ( 0 == s ? wxT("ParseCFiles") : wxT("ParseCFilesBroken") ), [&]()
+			{
+				// The missing bracket is reported with a warning
+				wxLogNull stopLogging;
+				parser.reset( new CCodeParser( header, source ) );
+				parser->ParseCFiles( wxT("BenchmarkClass") );
+			} );
+
+			for ( unsigned int i = 0; i < functions; ++i )
+			{
+				if ( parser->GetFunctionContents( headings[i] ) != bodies[i] )
+				{
+					THROW_WXFBEX( wxT("The body of ") << headings[i] << wxT(" was not parsed back") )
+				}
+			}
+
+			if ( parser->GetUserMembers() != wxT("int m_count; // { not a brace\n") )
+			{
+				THROW_WXFBEX( wxT("The user members of BenchmarkClass were not parsed back") )
+			}
+
+			wxString trailing = parser->GetTrailingCode();
+			if ( 1 == s && ( !trailing.Contains( broken.BeforeLast( wxT('\n') ) ) || !parser->GetFunctionContents( wxT("void BenchmarkClass::Broken()") ).empty() ) )
+			{
+				THROW_WXFBEX( wxT("The function without a closing bracket was not kept in the trailing code") )
+			}
+		}
+	}
+	catch ( ... )
+	{
+		wxRemoveFile( header );
+		wxRemoveFile( source );
+		throw;
+	}
+
+	wxRemoveFile( header );
+	wxRemoveFile( source );
+}
+
+std::string Benchmark::GetProjectXml()
+{
+	ticpp::Document doc;
+	AppData()->GetProjectData()->Serialize( &doc );
+
+	TiXmlPrinter printer;
+	doc.Accept( &printer );
+	return printer.CStr();
+}
+
+Benchmark::LoadState Benchmark::GetLoadState()
+{
+	LoadState state;
+	state.xml = GetProjectXml();
+
+	// Read before creating the widget, which counts it
+	for ( size_t i = 0; i < m_classes.size(); ++i )
+	{
+		state.counts.push_back( m_classes[i]->GetInstanceCount() );
+	}
+
+	PObjectBase button = m_objDb->CreateObject( "wxButton" );
+	state.name = button->GetPropertyAsString( wxT("name") );
+	return state;
+}
+
+Benchmark::LoadState Benchmark::LoadProject( const wxString& name, const wxString& path, bool concurrent )
+{
+	m_objDb->SetConcurrentLoad( concurrent );
+	Time( name, [&]()
+	{
+		if ( !AppData()->LoadProject( path, true ) )
+		{
+			THROW_WXFBEX( wxT("Unable to load ") << path )
+		}
+	} );
+	m_objDb->SetConcurrentLoad( true );
+
+	return GetLoadState();
+}
+
+void Benchmark::CompareLoadStates( const LoadState& serial, const LoadState& concurrent, const wxString& path )
+{
+	if ( concurrent.xml != serial.xml )
+	{
+		THROW_WXFBEX( path << wxT(" loaded concurrently differs from the project loaded serially") )
+	}
+
+	for ( size_t i = 0; i < m_classes.size(); ++i )
+	{
+		if ( concurrent.counts[i] != serial.counts[i] )
+		{
+			THROW_WXFBEX( path << wxT(" loaded concurrently counts ") << concurrent.counts[i] << wxT(" ")
+				<< m_classes[i]->GetClassName() << wxT(" instead of ") << serial.counts[i] )
+		}
+	}
+
+	if ( concurrent.name != serial.name )
+	{
+		THROW_WXFBEX( path << wxT(" loaded concurrently names a new button ") << concurrent.name
+			<< wxT(" instead of ") << serial.name )
+	}
+}
+
+// Removes the names of the objects below the element
+static void RemoveNames( ticpp::Element* parent )
+{
+	ticpp::Element* child = parent->FirstChildElement( "object", false );
+	while ( child )
+	{
+		ticpp::Element* property = child->FirstChildElement( "property", false );
+		while ( property )
+		{
+			ticpp::Element* next = property->NextSiblingElement( "property", false );
+			if ( property->GetAttribute( "name" ) == "name" )
+			{
+				child->RemoveChild( property );
+			}
+			property = next;
+		}
+
+		RemoveNames( child );
+		child = child->NextSiblingElement( "object", false );
+	}
+}
+
+void Benchmark::CheckDefaultNames( const wxString& projectFile )
+{
+	// Without the names in the file, the forms created concurrently number
+	// their objects as if they had been created one after the other
+	wxString unnamedFile = m_dir + wxT("benchmark_unnamed.fbp");
+
+	try
+	{
+		ticpp::Document doc;
+		XMLUtils::LoadXMLFile( doc, false, projectFile );
+
+		ticpp::Element* root = doc.FirstChildElement( "wxFormBuilder_Project" );
+		ticpp::Element* project = root->FirstChildElement( "object" );
+		RemoveNames( project );
+		doc.SaveFile( std::string( unnamedFile.mb_str( wxConvFile ) ) );
+
+		LoadState concurrent = LoadProject( wxT("LoadUnnamedProject"), unnamedFile, true );
+		LoadState serial = LoadProject( wxT("LoadUnnamedProjectSerial"), unnamedFile, false );
+		CompareLoadStates( serial, concurrent, unnamedFile );
+	}
+	catch ( ... )
+	{
+		wxRemoveFile( unnamedFile );
+		throw;
+	}
+
+	wxRemoveFile( unnamedFile );
+}
+
+wxString Benchmark::GetJson() const
+{
+	wxString json;
+	json << wxT("{\n");
+	json << wxT("  \"forms\": ") << m_options.forms << wxT(",\n");
+	json << wxT("  \"widgets\": ") << m_options.widgets << wxT(",\n");
+	json << wxT("  \"depth\": ") << m_options.depth << wxT(",\n");
+	json << wxT("  \"iterations\": ") << m_options.iterations << wxT(",\n");
+	json << wxT("  \"objects\": ") << m_count << wxT(",\n");
+	json << wxT("  \"results\": {");
+
+	for ( size_t i = 0; i < m_results.size(); ++i )
+	{
+		const std::vector< double >& times = m_results[i].times;
+
+		double total = 0;
+		for ( size_t t = 0; t < times.size(); ++t )
+		{
+			total += times[t];
+		}
+
+		json << ( i > 0 ? wxT(",\n") : wxT("\n") );
+		json << wxT("    \"") << m_results[i].name << wxT("\": { ")
+			 << wxT("\"min\": ") << TypeConv::FloatToString( *std::min_element( times.begin(), times.end() ) ) << wxT(", ")
+			 << wxT("\"max\": ") << TypeConv::FloatToString( *std::max_element( times.begin(), times.end() ) ) << wxT(", ")
+			 << wxT("\"mean\": ") << TypeConv::FloatToString( total / times.size() ) << wxT(" }");
+	}
+
+	json << wxT("\n  },\n");
+
+	// Compare between builds to see how much memory a loaded project takes
+	json << wxT("  \"memory\": {\n");
+	json << wxT("    \"rss_before_load_kb\": ") << m_rssBeforeLoad << wxT(",\n");
+	json << wxT("    \"rss_after_load_kb\": ") << m_rssAfterLoad << wxT(",\n");
+	json << wxT("    \"peak_rss_kb\": ") << m_rssPeak << wxT(",\n");
+	json << wxT("    \"pooled_values\": ") << (unsigned long)m_pool.values << wxT(",\n");
+	json << wxT("    \"pooled_references\": ") << (unsigned long)m_pool.references << wxT(",\n");
+	json << wxT("    \"pooled_chars\": ") << (unsigned long)m_pool.chars << wxT("\n");
+	json << wxT("  }\n}\n");
+	return json;
+}
+
+bool Benchmark::CreateFiles()
+{
+	m_dir = wxStandardPaths::Get().GetTempDir() + wxFILE_SEP_PATH + wxString::Format( wxT("wxfb-benchmark-%lu"), ::wxGetProcessId() ) + wxFILE_SEP_PATH;
+	if ( !wxFileName::Mkdir( m_dir, 0777, wxPATH_MKDIR_FULL ) )
+	{
+		wxLogError( _("Unable to create the directory %s"), m_dir.c_str() );
+		return false;
+	}
+
+	m_bitmap = m_dir + wxT("benchmark.xpm");
+	wxFFile xpm( m_bitmap, wxT("wb") );
+	bool written = xpm.IsOpened() && xpm.Write( s_xpm, sizeof( s_xpm ) - 1 );
+	xpm.Close();
+	if ( !written )
+	{
+		wxLogError( _("Unable to write %s"), m_bitmap.c_str() );
+		RemoveFiles( wxEmptyString );
+		return false;
+	}
+
+	return true;
+}
+
+void Benchmark::RemoveFiles( const wxString& projectFile )
+{
+	m_objDb->SetConcurrentLoad( true );
+	AppData()->NewProject();
+	if ( !projectFile.empty() )
+	{
+		wxRemoveFile( projectFile );
+	}
+	wxRemoveFile( m_bitmap );
+	wxRmdir( m_dir );
+}
+
+void Benchmark::LoadClasses()
+{
+	// Every class of the loaded plugins
+	m_classes.clear();
+	for ( unsigned int p = 0; p < m_objDb->GetPackageCount(); ++p )
+	{
+		PObjectPackage package = m_objDb->GetPackage( p );
+		for ( unsigned int i = 0; i < package->GetObjectCount(); ++i )
+		{
+			m_classes.push_back( package->GetObjectInfo( i ) );
+		}
+	}
+}
+
+void Benchmark::SaveProject( PObjectBase project, const wxString& path )
+{
+	ticpp::Document doc;
+	project->Serialize( &doc );
+	doc.SaveFile( std::string( path.mb_str( wxConvFile ) ) );
+}
+
+bool Benchmark::SelfTest()
+{
+	if ( !CreateFiles() )
+	{
+		return false;
+	}
+
+	wxString projectFile = m_dir + wxT("benchmark.fbp");
+
+	bool result = true;
+	try
+	{
+		CheckEscapeString();
+		CheckCodeParser();
+		LoadClasses();
+
+		m_count = 0;
+		SaveProject( CreateProject(), projectFile );
+
+		LoadState concurrent = LoadProject( wxT("LoadProject"), projectFile, true );
+		LoadState serial = LoadProject( wxT("LoadProjectSerial"), projectFile, false );
+		CompareLoadStates( serial, concurrent, projectFile );
+
+		CheckDefaultNames( projectFile );
+	}
+	catch ( wxFBException& ex )
+	{
+		wxLogError( ex.what() );
+		result = false;
+	}
+	catch ( ticpp::Exception& ex )
+	{
+		wxLogError( _WXSTR( ex.m_details ) );
+		result = false;
+	}
+
+	RemoveFiles( projectFile );
+
+	if ( result )
+	{
+		wxLogMessage( _("All the checks passed.") );
+	}
+	return result;
+}
+
+bool Benchmark::Run( const wxString& output )
+{
+	if ( !CreateFiles() )
+	{
+		return false;
+	}
+
+	wxString projectFile = m_dir + wxT("benchmark.fbp");
+
+	bool result = true;
+	try
+	{
+		CheckEscapeString();
+		CheckCodeParser();
+		LoadClasses();
+
+		// Every pair of classes of the loaded plugins
+		Time( wxT("IsSubclassOf"), [&]()
+		{
+			unsigned int subclasses = 0;
+			for ( size_t i = 0; i < m_classes.size(); ++i )
+			{
+				for ( size_t j = 0; j < m_classes.size(); ++j )
+				{
+					if ( m_classes[i]->IsSubclassOf( m_classes[j]->GetClassName() ) )
+					{
+						++subclasses;
+					}
+				}
+			}
+			LogDebug( wxT("%u subclass pairs"), subclasses );
+		} );
+
+		PObjectBase project;
+		Time( wxT("CreateProject"), [&]()
+		{
+			m_count = 0;
+			project = CreateProject();
+		} );
+
+		SaveProject( project, projectFile );
+		project.reset();
+
+		m_rssBeforeLoad = GetResidentMemory();
+		Time( wxT("LoadProject"), [&]()
+		{
+			if ( !AppData()->LoadProject( projectFile, true ) )
+			{
+				THROW_WXFBEX( wxT("Unable to load ") << projectFile )
+			}
+		} );
+		m_rssAfterLoad = GetResidentMemory();
+		m_rssPeak = GetPeakResidentMemory();
+		m_pool = StringPool::GetStats();
+
+		// The forms are created concurrently, the project and the instance
+		// counts must be the same as when created one form after the other
+		LoadState concurrent = GetLoadState();
+		LoadState serial = LoadProject( wxT("LoadProjectSerial"), projectFile, false );
+		CompareLoadStates( serial, concurrent, projectFile );
+
+		Time( wxT("SaveProject"), [&]()
+		{
+			AppData()->SaveProject( projectFile );
+		} );
+
+		project = AppData()->GetProjectData();
+
+		// The flags and styles read by the designer for every widget
+		std::vector< PProperty > bitlists;
+		std::vector< PObjectBase > objects( 1, project );
+		while ( !objects.empty() )
+		{
+			PObjectBase object = objects.back();
+			objects.pop_back();
+
+			for ( unsigned int i = 0; i < object->GetPropertyCount(); ++i )
+			{
+				PProperty prop = object->GetProperty( i );
+				PropertyType type = prop->GetType();
+				if ( PT_BITLIST == type || PT_OPTION == type || PT_EDIT_OPTION == type || PT_MACRO == type )
+				{
+					bitlists.push_back( prop );
+				}
+			}
+
+			for ( unsigned int i = 0; i < object->GetChildCount(); ++i )
+			{
+				objects.push_back( object->GetChild( i ) );
+			}
+		}
+
+		Time( wxT("GetValueAsInteger"), [&]()
+		{
+			int values = 0;
+			for ( size_t i = 0; i < bitlists.size(); ++i )
+			{
+				values |= bitlists[i]->GetValueAsInteger();
+			}
+			LogDebug( wxT("%lu bitlist and macro properties, %d"), (unsigned long)bitlists.size(), values );
+		} );
+
+		Time( wxT("CppCodeGenerator"), [&]()
+		{
+			CppCodeGenerator codegen;
+			codegen.SetHeaderWriter( PCodeWriter( new StringCodeWriter ) );
+			codegen.SetSourceWriter( PCodeWriter( new StringCodeWriter ) );
+			codegen.GenerateCode( project );
+		} );
+
+		Time( wxT("PythonCodeGenerator"), [&]()
+		{
+			PythonCodeGenerator codegen;
+			codegen.SetSourceWriter( PCodeWriter( new StringCodeWriter ) );
+			codegen.GenerateCode( project );
+		} );
+
+		Time( wxT("LuaCodeGenerator"), [&]()
+		{
+			LuaCodeGenerator codegen;
+			codegen.SetSourceWriter( PCodeWriter( new StringCodeWriter ) );
+			codegen.GenerateCode( project );
+		} );
+
+		Time( wxT("PHPCodeGenerator"), [&]()
+		{
+			PHPCodeGenerator codegen;
+			codegen.SetSourceWriter( PCodeWriter( new StringCodeWriter ) );
+			codegen.GenerateCode( project );
+		} );
+
+		std::shared_ptr< StringCodeWriter > xrc( new StringCodeWriter );
+		Time( wxT("XrcCodeGenerator"), [&]()
+		{
+			xrc->Clear();
+			XrcCodeGenerator codegen;
+			codegen.SetWriter( xrc );
+			codegen.GenerateCode( project );
+		} );
+
+		Time( wxT("CopyObject"), [&]()
+		{
+			for ( unsigned int i = 0; i < project->GetChildCount(); ++i )
+			{
+				m_objDb->CopyObject( project->GetChild( i ) );
+			}
+		} );
+
+		std::string xrcText( xrc->GetString().mb_str( wxConvUTF8 ) );
+		Time( wxT("XrcImport"), [&]()
+		{
+			ticpp::Document xrcDoc;
+			xrcDoc.Parse( xrcText, true, TIXML_ENCODING_UTF8 );
+
+			XrcLoader loader;
+			loader.SetObjectDatabase( m_objDb );
+			if ( !loader.GetProject( &xrcDoc ) )
+			{
+				THROW_WXFBEX( wxT("Unable to import the generated XRC") )
+			}
+		} );
+
+		CheckDefaultNames( projectFile );
+	}
+	catch ( wxFBException& ex )
+	{
+		wxLogError( ex.what() );
+		result = false;
+	}
+	catch ( ticpp::Exception& ex )
+	{
+		wxLogError( _WXSTR( ex.m_details ) );
+		result = false;
+	}
+
+	RemoveFiles( projectFile );
+
+	if ( !result )
+	{
+		return false;
+	}
+
+	wxString json = GetJson();
+	if ( output == wxT("-") )
+	{
+		wxPrintf( wxT("%s"), json.c_str() );
+		return true;
+	}
+
+	wxFFile file( output, wxT("wb") );
+	if ( !file.IsOpened() || !file.Write( json, wxConvUTF8 ) )
+	{
+		wxLogError( _("Unable to write the benchmark results: %s"), output.c_str() );
+		return false;
+	}
+
+	return true;
+}
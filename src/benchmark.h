@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include "utils/wxfbdefs.h"
+#include "utils/stringpool.h"
+#include <wx/string.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Times the loading, saving and code generation of synthetic projects, so the
+ * performance can be compared between versions. The projects are built with
+ * the object database of the running application, which must be initialized.
+ * The results are also checked, so it doubles as a test of those operations.
+ */
+class Benchmark
+{
+public:
+	struct Options
+	{
+		unsigned int forms;      // top level forms
+		unsigned int widgets;    // widgets in each form
+		unsigned int depth;      // nested sizers in each form
+		unsigned int iterations; // times each operation is repeated
+	};
+
+private:
+	struct Result
+	{
+		wxString name;
+		std::vector< double > times; // milliseconds
+	};
+
+	// What a loaded project leaves behind for the objects created afterwards
+	struct LoadState
+	{
+		std::string xml;                    // the loaded project
+		std::vector< unsigned int > counts; // instance count of every class
+		wxString name;                      // default name of a new widget
+	};
+
+	Options m_options;
+	PObjectDatabase m_objDb;
+	unsigned int m_count;      // objects created
+	wxString m_dir;            // working directory, with trailing separator
+	wxString m_bitmap;         // embedded bitmap used by the widgets
+	std::vector< Result > m_results;
+	std::vector< PObjectInfo > m_classes; // every class of the loaded plugins
+	long m_rssBeforeLoad;      // resident memory in KB, -1 if unknown
+	long m_rssAfterLoad;
+	long m_rssPeak;            // highest resident memory once the project is loaded
+	StringPool::Stats m_pool;  // property values of the loaded project
+
+	PObjectBase Add( const char* className, PObjectBase parent );
+	PObjectBase CreateForm( PObjectBase project, unsigned int index );
+	PObjectBase CreateProject();
+	void SaveProject( PObjectBase project, const wxString& path );
+	void LoadClasses();
+	bool CreateFiles();
+	void RemoveFiles( const wxString& projectFile );
+	void Time( const wxString& name, std::function< void() > operation );
+	void CheckEscapeString();
+	void CheckCodeParser();
+	void CheckDefaultNames( const wxString& projectFile );
+	LoadState GetLoadState();
+	LoadState LoadProject( const wxString& name, const wxString& path, bool concurrent );
+	void CompareLoadStates( const LoadState& serial, const LoadState& concurrent, const wxString& path );
+	wxString GetJson() const;
+	std::string GetProjectXml();
+
+public:
+	Benchmark( const Options& options );
+
+	/**
+	 * Runs every benchmark and writes the results as JSON to the given file, or
+	 * to the standard output if it is "-". Errors are logged.
+	 */
+	bool Run( const wxString& output );
+
+	/**
+	 * Only runs the checks done along the benchmarks: the string escaping, the
+	 * code parser and the concurrent loading of the project. Returns false and
+	 * logs the error if one of them fails.
+	 */
+	bool SelfTest();
+};
+
+#endif //__BENCHMARK_H__
@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "codeanalysis.h"
+#include "model/objectbase.h"
+#include "utils/trace.h"
+
+#include <wx/stopwatch.h>
+#include <algorithm>
+
+ProjectAnalysis::ProjectAnalysis( PObjectBase project )
+:
+m_project( project ),
+m_time( 0 )
+{
+	if ( !project )
+	{
+		return;
+	}
+
+	TRACE_SCOPE( "codegen", "ProjectAnalysis" );
+	wxStopWatch watch;
+	Analyze( project, NULL );
+	m_time = watch.Time();
+}
+
+void ProjectAnalysis::Analyze( PObjectBase obj, FormData* form )
+{
+	// The maps are walked directly, GetProperty( idx ) would make this quadratic.
+	// The order is the same one of GetProperty( idx ), so the generated code does not change.
+	PropertyMap::iterator prop;
+	for ( prop = obj->m_properties.begin(); prop != obj->m_properties.end(); ++prop )
+	{
+		switch ( prop->second->GetType() )
+		{
+			case PT_MACRO:
+				AddMacro( prop->second->GetValue(), &m_macros );
+				if ( form )
+				{
+					AddMacro( prop->second->GetValue(), &form->macros );
+				}
+				break;
+			case PT_BITMAP:
+				m_bitmaps.push_back( prop->second );
+				break;
+			default:
+				break;
+		}
+	}
+
+	if ( form )
+	{
+		EventMap::iterator event;
+		for ( event = obj->m_events.begin(); event != obj->m_events.end(); ++event )
+		{
+			if ( !event->second->GetValue().empty() )
+			{
+				form->events.push_back( event->second );
+			}
+		}
+	}
+
+	for ( unsigned int i = 0; i < obj->GetChildCount(); i++ )
+	{
+		PObjectBase child = obj->GetChild( i );
+		m_dependencies.insert( child->GetObjectInfo() );
+
+		// Each child of the project starts a form
+		Analyze( child, form ? form : &m_forms[ child.get() ] );
+	}
+
+	if ( obj->m_properties.find( wxT("subclass") ) != obj->m_properties.end() )
+	{
+		m_subclassed.push_back( obj );
+	}
+}
+
+void ProjectAnalysis::AddMacro( const wxString& value, std::vector< wxString >* macros )
+{
+	if ( macros->end() == std::find( macros->begin(), macros->end(), value ) )
+	{
+		macros->push_back( value );
+	}
+}
+
+const std::vector< wxString >& ProjectAnalysis::GetMacros( PObjectBase form ) const
+{
+	static const std::vector< wxString > empty;
+
+	std::map< ObjectBase*, FormData >::const_iterator it = m_forms.find( form.get() );
+	return ( it != m_forms.end() ? it->second.macros : empty );
+}
+
+const EventVector& ProjectAnalysis::GetEventHandlers( PObjectBase form ) const
+{
+	static const EventVector empty;
+
+	std::map< ObjectBase*, FormData >::const_iterator it = m_forms.find( form.get() );
+	return ( it != m_forms.end() ? it->second.events : empty );
+}
+
+void ProjectAnalysis::FindEventHandlers( PObjectBase obj, EventVector* events )
+{
+	for ( unsigned int i = 0; i < obj->GetEventCount(); i++ )
+	{
+		PEvent event = obj->GetEvent( i );
+		if ( !event->GetValue().empty() )
+		{
+			events->push_back( event );
+		}
+	}
+
+	for ( unsigned int i = 0; i < obj->GetChildCount(); i++ )
+	{
+		FindEventHandlers( obj->GetChild( i ), events );
+	}
+}
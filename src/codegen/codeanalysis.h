@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CODE_ANALYSIS_
+#define _CODE_ANALYSIS_
+
+#include "utils/wxfbdefs.h"
+#include <wx/string.h>
+#include <set>
+#include <map>
+#include <vector>
+
+/**
+ * Language independent information about a project, gathered in a single walk
+ * of the object tree so the code generators of every language can share it
+ * instead of walking the project again for each piece of information.
+ */
+class ProjectAnalysis
+{
+private:
+	struct FormData
+	{
+		EventVector events;
+		std::vector< wxString > macros;
+	};
+
+	PObjectBase m_project;
+	std::map< ObjectBase*, FormData > m_forms;
+	std::vector< wxString > m_macros;
+	std::set< PObjectInfo > m_dependencies;
+	ObjectBaseVector m_subclassed;
+	std::vector< PProperty > m_bitmaps;
+	long m_time;
+
+	void Analyze( PObjectBase obj, FormData* form );
+	static void AddMacro( const wxString& value, std::vector< wxString >* macros );
+
+public:
+	/**
+	 * Walks the whole project. The objects are not copied, so the analysis
+	 * must not outlive changes to the project structure.
+	 */
+	ProjectAnalysis( PObjectBase project );
+
+	PObjectBase GetProject() const { return m_project; }
+
+	/**
+	 * Values of the PT_MACRO properties of the whole project, without duplicates,
+	 * in order of appearance.
+	 */
+	const std::vector< wxString >& GetMacros() const { return m_macros; }
+
+	/**
+	 * Same as GetMacros() but only for the objects of the given form.
+	 */
+	const std::vector< wxString >& GetMacros( PObjectBase form ) const;
+
+	/**
+	 * Events of the form and its children which have a handler, in tree order.
+	 */
+	const EventVector& GetEventHandlers( PObjectBase form ) const;
+
+	/**
+	 * Classes of all the objects below the project.
+	 */
+	const std::set< PObjectInfo >& GetDependencies() const { return m_dependencies; }
+
+	/**
+	 * Objects with a "subclass" property, children before their parents.
+	 */
+	const ObjectBaseVector& GetSubclassedObjects() const { return m_subclassed; }
+
+	/**
+	 * All the PT_BITMAP properties of the project.
+	 */
+	const std::vector< PProperty >& GetBitmapProperties() const { return m_bitmaps; }
+
+	/**
+	 * Time spent walking the project, in milliseconds.
+	 */
+	long GetTime() const { return m_time; }
+
+	/**
+	 * Events of obj and its children which have a handler, for objects which
+	 * are not part of an analysed project.
+	 */
+	static void FindEventHandlers( PObjectBase obj, EventVector* events );
+};
+
+#endif //_CODE_ANALYSIS_
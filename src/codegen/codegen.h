@@ -36,6 +36,8 @@
 #include <map>
 #include "utils/wxfbdefs.h"
 #include "model/types.h"
+#include "codeanalysis.h"
+#include <memory>
 
 /**
 * Template notes
@@ -271,13 +273,43 @@ public:
 */
 class CodeGenerator
 {
+private:
+	std::shared_ptr< ProjectAnalysis > m_sharedAnalysis;
+
 protected:
+	/**
+	* Analysis of the project being generated, see AnalyzeProject().
+	*/
+	std::shared_ptr< ProjectAnalysis > m_analysis;
+
+	/**
+	* Sets m_analysis for the project, reusing the one passed to SetAnalysis()
+	* when it belongs to the same project.
+	*/
+	void AnalyzeProject( PObjectBase project )
+	{
+		if ( m_sharedAnalysis && m_sharedAnalysis->GetProject() == project )
+		{
+			m_analysis = m_sharedAnalysis;
+		}
+		else
+		{
+			m_analysis.reset( new ProjectAnalysis( project ) );
+		}
+	}
 
 public:
 	/**
 	* Virtual destructor.
 	*/
 	virtual ~CodeGenerator() {};
+
+	/**
+	* Shares an analysis of the project between the generators of several
+	* languages, so the project is walked only once.
+	*/
+	void SetAnalysis( std::shared_ptr< ProjectAnalysis > analysis ) { m_sharedAnalysis = analysis; }
+
 	/**
 	* Generate the code of the project
 	*/
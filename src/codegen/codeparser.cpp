@@ -1,19 +1,147 @@
 
 #include "codeparser.h"
+#include <wx/convauto.h>
+#include <wx/ffile.h>
+#include <wx/log.h>
 
 wxString RemoveWhiteSpace(wxString str)
 {
-	size_t index = 0;
-	while(index < str.Len())
+	wxString result;
+	result.reserve(str.Len());
+	for (size_t index = 0; index < str.Len(); index++)
 	{
-		if(str.GetChar(index) == ' ' || str.GetChar(index) == '\t' || str.GetChar(index) == '\n')
+		wxChar ch = str.GetChar(index);
+		if (ch != ' ' && ch != '\t' && ch != '\n')
 		{
-			str.Remove(index, 1);
+			result << ch;
 		}
-		else
-		{index++;}
 	}
-	return str;
+	return result;
+}
+
+namespace
+{
+	bool IsIdentifierChar(wxChar ch)
+	{
+		return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+	}
+
+	/** returns the position just after the comment or literal starting at 'pos', or 'pos' if there is none */
+	size_t SkipCommentOrLiteral(const wxChar* code, size_t length, size_t pos)
+	{
+		wxChar ch = code[pos];
+		if (ch == '/' && pos + 1 < length)
+		{
+			if (code[pos + 1] == '/')
+			{
+				// line comment, the newline is left to the caller
+				pos += 2;
+				while (pos < length && code[pos] != '\n')
+				{
+					pos++;
+				}
+				return pos;
+			}
+			if (code[pos + 1] == '*')
+			{
+				pos += 2;
+				while (pos + 1 < length && !(code[pos] == '*' && code[pos + 1] == '/'))
+				{
+					pos++;
+				}
+				return (pos + 1 < length ? pos + 2 : length);
+			}
+		}
+		else if (ch == '"' || ch == '\'')
+		{
+			// string or character literal, stops at the end of the line if it is not closed
+			pos++;
+			while (pos < length && code[pos] != ch && code[pos] != '\n')
+			{
+				if (code[pos] == '\\')
+				{
+					pos++;
+				}
+				pos++;
+			}
+			return (pos < length && code[pos] == ch ? pos + 1 : pos);
+		}
+		return pos;
+	}
+
+	/** returns the position of the '}' closing the block opened at 'open', or wxNOT_FOUND */
+	int FindClosingBracket(const wxChar* code, size_t length, size_t open)
+	{
+		int depth = 0;
+		size_t pos = open;
+		while (pos < length)
+		{
+			size_t next = SkipCommentOrLiteral(code, length, pos);
+			if (next != pos)
+			{
+				pos = next;
+				continue;
+			}
+
+			if (code[pos] == '{')
+			{
+				depth++;
+			}
+			else if (code[pos] == '}')
+			{
+				depth--;
+				if (depth == 0)
+				{
+					return pos;
+				}
+			}
+			pos++;
+		}
+		return wxNOT_FOUND;
+	}
+
+	/** returns the position of the first '{' outside comments and literals from 'pos', or wxNOT_FOUND */
+	int FindOpeningBracket(const wxChar* code, size_t length, size_t pos)
+	{
+		while (pos < length)
+		{
+			size_t next = SkipCommentOrLiteral(code, length, pos);
+			if (next != pos)
+			{
+				pos = next;
+				continue;
+			}
+			if (code[pos] == '{')
+			{
+				return pos;
+			}
+			pos++;
+		}
+		return wxNOT_FOUND;
+	}
+
+	/** reads a whole text file at once, with '\n' line endings */
+	wxString ReadTextFile(const wxString& fileName)
+	{
+		wxString text;
+		if (!wxFileExists(fileName))
+		{
+			return text;
+		}
+
+		wxFFile file(fileName, wxT("rb"));
+		if (!file.IsOpened() || !file.ReadAll(&text, wxConvAuto()))
+		{
+			return wxT("");
+		}
+
+		text.Replace(wxT("\r\n"), wxT("\n"));
+		if (!text.empty() && text.Last() != '\n')
+		{
+			text << wxT('\n');
+		}
+		return text;
+	}
 }
 
 void Function::SetHeading(wxString heading)
@@ -57,53 +185,16 @@ wxString Function::GetFunction()
 void CCodeParser::ParseCFiles(wxString className)
 {
 	m_className = className;
-	wxTextFile headerFile(m_hFile);
-	wxTextFile sourceFile(m_cFile);
-
-	wxString header;
-	wxString source;
 
-	//start opening files
-	if (headerFile.Open())
-	{
-		wxString Str;
-
-		Str = headerFile.GetFirstLine();
-		while (!(headerFile.Eof()))
-		{
-			header << Str;
-			header << wxT('\n');
-			Str = headerFile.GetNextLine();
-		}
-		headerFile.Close();
-	}
-	else
-	{
-		header = wxT("");
-	}
-	if (sourceFile.Open())
-	{
-		wxString Str;
-
-		source = sourceFile.GetFirstLine();
-		while (!(sourceFile.Eof()))
-		{
-			source << Str;
-			source << wxT('\n');
-			Str = sourceFile.GetNextLine();
-		}
-		sourceFile.Close();
-	}
-	else
-	{
-		source = wxT("");
-	}
+	//read the whole files at once, parsing is done on the complete text
+	wxString header = ReadTextFile(m_hFile);
+	wxString source = ReadTextFile(m_cFile);
 
 	//parse the file contents
 	ParseCCode(header, source);
 }
 
-void CCodeParser::ParseCCode(wxString header, wxString source)
+void CCodeParser::ParseCCode(const wxString& header, const wxString& source)
 {
 	ParseCInclude(header);
 	ParseCClass(header);
@@ -111,7 +202,7 @@ void CCodeParser::ParseCCode(wxString header, wxString source)
 	ParseSourceFunctions(source);
 }
 
-void CCodeParser::ParseCInclude(wxString code)
+void CCodeParser::ParseCInclude(const wxString& code)
 {
 	int userIncludeEnd;
 	m_userInclude = wxT("");
@@ -135,20 +226,20 @@ void CCodeParser::ParseCInclude(wxString code)
 	}
 }
 
-void CCodeParser::ParseCClass(wxString code)
+void CCodeParser::ParseCClass(const wxString& code)
 {
 	int startClass = code.Find(wxT("class ") + m_className);
 	if (startClass != wxNOT_FOUND)
 	{
-		code = ParseBrackets(code, startClass);
+		wxString classCode = ParseBrackets(code, startClass);
 		if (startClass != wxNOT_FOUND)
 		{
-			ParseCUserMembers(code);
+			ParseCUserMembers(classCode);
 		}
 	}
 }
 
-void CCodeParser::ParseCUserMembers(wxString code)
+void CCodeParser::ParseCUserMembers(const wxString& code)
 {
 	m_userMemebers = wxT("");
 	int userMembersStart = code.Find(wxT("//// end generated class members"));
@@ -171,116 +262,133 @@ void CCodeParser::ParseCUserMembers(wxString code)
 	}
 }
 
-void CCodeParser::ParseSourceFunctions(wxString code)
+void CCodeParser::ParseSourceFunctions(const wxString& code)
 {
-	int functionStart = 0;
-	int functionEnd = 0;
-	int previousFunctionEnd = 0;
-	wxString funcName, funcArg;
-	Function *func;
-	wxString Str, R;
-
-	int loop = 0;
-	while (1)
+	// Single pass over the source: the braces in comments and literals are skipped,
+	// the functions are the blocks that follow "className::" outside of any block
+	const wxChar* data = code.c_str();
+	const size_t length = code.Len();
+	const wxString scope = m_className + wxT("::");
+
+	size_t previousFunctionEnd = 0;
+	size_t lineStart = 0;
+	int functionStart = wxNOT_FOUND;
+	size_t pos = 0;
+
+	while (pos < length)
 	{
-		//find the begining of the function name
-		Str = m_className + wxT("::");
-		functionStart = code.find(Str, previousFunctionEnd);
-		if (functionStart == wxNOT_FOUND)
+		size_t next = SkipCommentOrLiteral(data, length, pos);
+		if (next != pos)
 		{
-			//Get the last bit of remaining code after the last function in the file
-			m_trailingCode = code.Mid(previousFunctionEnd);
-			m_trailingCode.RemoveLast();
-			return;
+			pos = next;
+			continue;
 		}
-		//found a function now creat a new function class
-		func = new Function();
-
-		//find the begining of the line on which the function name resides
-		functionStart = code.rfind('\n', functionStart);
-		func->SetDocumentation(code.Mid(previousFunctionEnd, functionStart - previousFunctionEnd));
-		functionStart++;
 
-		functionEnd = code.find('{', functionStart);
-		wxString heading = code.Mid(functionStart, functionEnd - functionStart);
-		if(heading.Right(1) == '\n')
-		{heading.RemoveLast();}
-		func->SetHeading(heading);
-
-		m_functions[RemoveWhiteSpace(heading)] = func;
-
-		//find the opening brackets of the function
-		func->SetContents(ParseBrackets(code,  functionStart));
-		if (functionStart != wxNOT_FOUND)
-		{
-			functionEnd = functionStart;
-		}
-		else
+		wxChar ch = data[pos];
+		if (ch == '\n')
 		{
-			wxMessageBox(wxT("Brackets Missing in Source File!"));
-			code.insert(functionEnd +1, wxT("//The Following Block is missing a closing bracket\n//and has been set aside by wxFormbuilder\n"));
-			func->SetContents(wxT(""));
+			lineStart = pos + 1;
 		}
-
-		previousFunctionEnd = functionEnd;
-		if (loop == 100)
+		else if (ch == ';' && functionStart != wxNOT_FOUND)
 		{
-			return;
+			//a declaration like "int className::member = 0;", not a function
+			functionStart = wxNOT_FOUND;
 		}
-		loop++;
-	}
-}
-
-wxString CCodeParser::ParseBrackets(wxString code, int& functionStart)
-{
-	int openingBrackets = 0;
-	int closingBrackets = 0;
-	int index = 0;
-	wxString Str;
-
-	int functionLength = 0;
-	index = code.find('{', functionStart);
-	if (index != wxNOT_FOUND)
-	{
-		openingBrackets++;
-		index++;
-		functionStart = index;
-		int loop = 0;
-		while (openingBrackets > closingBrackets)
+		else if (ch == '{')
 		{
-			index = code.find_first_of(wxT("{}"), index);
-			if (index == wxNOT_FOUND)
+			int closing = FindClosingBracket(data, length, pos);
+			if (functionStart == wxNOT_FOUND)
 			{
-				Str = code.Mid(functionStart, index);
-				functionStart = index;
-				return Str;
+				//some other block, skip it
+				if (closing == wxNOT_FOUND)
+				{
+					break;
+				}
+				pos = closing + 1;
+				continue;
 			}
-			if (code.GetChar(index) == '{')
+
+			if (closing == wxNOT_FOUND)
 			{
-				index++;
-				openingBrackets++;
+				//keep the code so it is not lost, but do not take it as a function
+				wxLogWarning(wxT("Brackets missing in source file %s"), m_cFile.c_str());
+				m_trailingCode = code.Mid(previousFunctionEnd, functionStart - previousFunctionEnd);
+				m_trailingCode << wxT("//The Following Block is missing a closing bracket\n//and has been set aside by wxFormbuilder\n");
+				m_trailingCode << code.Mid(functionStart);
+				if (!m_trailingCode.empty())
+				{
+					m_trailingCode.RemoveLast();
+				}
+				return;
 			}
-			else
+
+			//found a function now create a new function class
+			Function* func = new Function();
+			func->SetDocumentation(code.Mid(previousFunctionEnd, functionStart - previousFunctionEnd));
+
+			wxString heading = code.Mid(functionStart, pos - functionStart);
+			if (heading.Right(1) == '\n')
 			{
-				index++;
-				closingBrackets++;
+				heading.RemoveLast();
 			}
-			if (loop == 100)
+			func->SetHeading(heading);
+			func->SetContents(code.Mid(pos + 1, closing - pos - 1));
+
+			//a function defined twice keeps the last definition
+			wxString key = RemoveWhiteSpace(heading);
+			funcIterator existing = m_functions.find(key);
+			if (existing != m_functions.end())
 			{
-				return wxT("");
+				delete existing->second;
 			}
-			loop++;
+			m_functions[key] = func;
+
+			previousFunctionEnd = closing + 1;
+			functionStart = wxNOT_FOUND;
+			pos = closing + 1;
+			continue;
 		}
-		index--;
-		functionLength = index - functionStart;
+		else if (functionStart == wxNOT_FOUND && ch == scope.GetChar(0) && (pos == 0 || !IsIdentifierChar(data[pos - 1]))
+				 && code.compare(pos, scope.Len(), scope) == 0)
+		{
+			//the function starts at the begining of the line on which its name resides
+			functionStart = (lineStart > previousFunctionEnd ? lineStart : previousFunctionEnd);
+			pos += scope.Len();
+			continue;
+		}
+		pos++;
+	}
+
+	//Get the last bit of remaining code after the last function in the file
+	m_trailingCode = code.Mid(previousFunctionEnd);
+	if (!m_trailingCode.empty())
+	{
+		m_trailingCode.RemoveLast();
+	}
+}
+
+wxString CCodeParser::ParseBrackets(const wxString& code, int& functionStart)
+{
+	const wxChar* data = code.c_str();
+	const size_t length = code.Len();
+
+	int opening = FindOpeningBracket(data, length, functionStart);
+	if (opening == wxNOT_FOUND)
+	{
+		wxLogWarning(wxT("No brackets found"));
+		functionStart = wxNOT_FOUND;
+		return wxT("");
 	}
-	else
+
+	int closing = FindClosingBracket(data, length, opening);
+	if (closing == wxNOT_FOUND)
 	{
-		wxMessageBox(wxT("no brackets found"));
+		functionStart = wxNOT_FOUND;
+		return code.Mid(opening + 1);
 	}
-	Str = code.Mid(functionStart, functionLength);
-	functionStart = functionStart + functionLength + 1;
-	return Str;
+
+	functionStart = closing + 1;
+	return code.Mid(opening + 1, closing - opening - 1);
 }
 
 wxString CodeParser::GetFunctionDocumentation(wxString function)
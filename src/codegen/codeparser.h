@@ -153,19 +153,21 @@ class CCodeParser : public CodeParser
 			void ParseCFiles(wxString className);
 
 			/** extracts the contents of the files.  take the the entire contents of both files in string form */
-			void ParseCCode(wxString header, wxString source);
+			void ParseCCode(const wxString& header, const wxString& source);
 
 			/** extracts all user header include code before the class declaration */
-			void ParseCInclude(wxString code);
+			void ParseCInclude(const wxString& code);
 
 			/** extracts the contents of the generated class declaration */
-			void ParseCClass(wxString code);
+			void ParseCClass(const wxString& code);
 
-			void ParseSourceFunctions(wxString code);
+			/** indexes the bodies of all 'className::' functions in a single pass, skipping braces in comments and literals */
+			void ParseSourceFunctions(const wxString& code);
 
-			wxString ParseBrackets(wxString code, int& functionStart);
+			/** returns the contents of the first block after 'functionStart', which is moved after its closing bracket or set to wxNOT_FOUND */
+			wxString ParseBrackets(const wxString& code, int& functionStart);
 
-			void ParseCUserMembers(wxString code);
+			void ParseCUserMembers(const wxString& code);
 
 		/***************/
 };
@@ -32,6 +32,7 @@
 #include "model/database.h"
 #include "utils/wxfbexception.h"
 #include "utils/filetocarray.h"
+#include "utils/trace.h"
 
 #include <algorithm>
 
@@ -350,42 +351,9 @@ CppCodeGenerator::CppCodeGenerator()
 	m_firstID = 1000;
 }
 
-wxString CppCodeGenerator::ConvertCppString( wxString text )
+wxString CppCodeGenerator::ConvertCppString( const wxString& text )
 {
-	wxString result;
-
-	for ( size_t i = 0; i < text.length(); i++ )
-	{
-		wxChar c = text[i];
-
-		switch ( c )
-		{
-			case wxT( '"' ):
-							result += wxT( "\\\"" );
-				break;
-
-			case wxT( '\\' ):
-							result += wxT( "\\\\" );
-				break;
-
-			case wxT( '\t' ):
-							result += wxT( "\\t" );
-				break;
-
-			case wxT( '\n' ):
-							result += wxT( "\\n" );
-				break;
-
-			case wxT( '\r' ):
-							result += wxT( "\\r" );
-				break;
-
-			default:
-				result += c;
-				break;
-		}
-	}
-	return result;
+	return TypeConv::EscapeString( text, true );
 }
 
 wxString CppCodeGenerator::ConvertEmbeddedBitmapName( const wxString& text )
@@ -472,7 +440,7 @@ void CppCodeGenerator::GenerateInheritedClass( PObjectBase userClasses, PObjectB
 
 	// Do events in both files
 	EventVector events;
-	FindEventHandlers( form, events );
+	ProjectAnalysis::FindEventHandlers( form, &events );
 
 	if ( events.size() > 0 )
 	{
@@ -562,12 +530,16 @@ void CppCodeGenerator::GenerateInheritedClass( PObjectBase userClasses, PObjectB
 
 bool CppCodeGenerator::GenerateCode( PObjectBase project )
 {
+	TRACE_SCOPE( "codegen", "CppCodeGenerator::GenerateCode" );
+
 	if ( !project )
 	{
 		wxLogError( wxT( "There is no project to generate code" ) );
 		return false;
 	}
 
+	AnalyzeProject( project );
+
 	bool useEnum = false;
 
 	PProperty useEnumProperty = project->GetProperty( wxT( "use_enum" ) );
@@ -627,7 +599,7 @@ bool CppCodeGenerator::GenerateCode( PObjectBase project )
 	std::set< wxString > subclassSourceIncludes;
 	std::vector< wxString > headerIncludes;
 
-	GenSubclassSets( project, &subclasses, &subclassSourceIncludes, &headerIncludes );
+	GenSubclassSets( &subclasses, &subclassSourceIncludes, &headerIncludes );
 
 	// Write the forward declaration lines
 	std::set< wxString >::iterator subclass_it;
@@ -769,8 +741,7 @@ bool CppCodeGenerator::GenerateCode( PObjectBase project )
 	{
 		PObjectBase child = project->GetChild( i );
 
-		EventVector events;
-		FindEventHandlers( child, events );
+		const EventVector& events = m_analysis->GetEventHandlers( child );
 		GenClassDeclaration( child, useEnum, classDecoration, events );
 		if ( !m_useConnect )
 		{
@@ -1199,7 +1170,7 @@ void CppCodeGenerator::GenClassDeclaration( PObjectBase class_obj, bool use_enum
 void CppCodeGenerator::GenEnumIds( PObjectBase class_obj )
 {
 	std::vector< wxString > macros;
-	FindMacros( class_obj, &macros );
+	FilterMacros( m_analysis->GetMacros( class_obj ), &macros );
 
 	std::vector< wxString >::iterator it = macros.begin();
 	if ( it != macros.end() )
@@ -1241,14 +1212,18 @@ void CppCodeGenerator::GenEnumIds( PObjectBase class_obj )
 	}
 }
 
-void CppCodeGenerator::GenSubclassSets( PObjectBase obj, std::set< wxString >* subclasses, std::set< wxString >* sourceIncludes, std::vector< wxString >* headerIncludes )
+void CppCodeGenerator::GenSubclassSets( std::set< wxString >* subclasses, std::set< wxString >* sourceIncludes, std::vector< wxString >* headerIncludes )
 {
-	// Call GenSubclassForwardDeclarations on all children as well
-	for ( unsigned int i = 0; i < obj->GetChildCount(); i++ )
+	// The analysis lists the objects with children before their parents
+	const ObjectBaseVector& objects = m_analysis->GetSubclassedObjects();
+	for ( ObjectBaseVector::const_iterator it = objects.begin(); it != objects.end(); ++it )
 	{
-		GenSubclassSets( obj->GetChild( i ), subclasses, sourceIncludes, headerIncludes );
+		GenSubclassSet( *it, subclasses, sourceIncludes, headerIncludes );
 	}
+}
 
+void CppCodeGenerator::GenSubclassSet( PObjectBase obj, std::set< wxString >* subclasses, std::set< wxString >* sourceIncludes, std::vector< wxString >* headerIncludes )
+{
 	// Fill the set
 	PProperty subclass = obj->GetProperty( wxT( "subclass" ) );
 	if ( subclass )
@@ -1470,21 +1445,6 @@ void CppCodeGenerator::AddUniqueIncludes( const wxString& include, std::vector<
 	}
 }
 
-void CppCodeGenerator::FindDependencies( PObjectBase obj, std::set< PObjectInfo >& info_set )
-{
-	unsigned int ch_count = obj->GetChildCount();
-	if ( ch_count > 0 )
-	{
-		unsigned int i;
-		for ( i = 0; i < ch_count; i++ )
-		{
-			PObjectBase child = obj->GetChild( i );
-			info_set.insert( child->GetObjectInfo() );
-			FindDependencies( child, info_set );
-		}
-	}
-}
-
 void CppCodeGenerator::GenConstructor( PObjectBase class_obj, const EventVector &events )
 {
 	m_source->WriteLn();
@@ -1759,57 +1719,25 @@ void CppCodeGenerator::GenConstruction( PObjectBase obj, bool is_widget )
 	}
 }
 
-void CppCodeGenerator::FindMacros( PObjectBase obj, std::vector<wxString>* macros )
+void CppCodeGenerator::FilterMacros( const std::vector< wxString >& values, std::vector< wxString >* macros )
 {
-	// iterate through all of the properties of all objects, add the macros
-	// to the vector
-	unsigned int i;
-
-	for ( i = 0; i < obj->GetPropertyCount(); i++ )
+	std::vector< wxString >::const_iterator it;
+	for ( it = values.begin(); it != values.end(); ++it )
 	{
-		PProperty prop = obj->GetProperty( i );
-		if ( prop->GetType() == PT_MACRO )
+		const wxString& value = *it;
+		// Skip wx IDs
+		if ( ( ! value.Contains( wxT("XRCID" ) ) ) &&
+			 ( m_predMacros.end() == m_predMacros.find( value ) ) )
 		{
-			wxString value = prop->GetValue();
-			// Skip wx IDs
-			if ( ( ! value.Contains( wxT("XRCID" ) ) ) &&
-				 ( m_predMacros.end() == m_predMacros.find( value ) ) )
-			{
-				if ( macros->end() == std::find( macros->begin(), macros->end(), value ) )
-				{
-					macros->push_back( value );
-				}
-			}
+			macros->push_back( value );
 		}
 	}
-
-	for ( i = 0; i < obj->GetChildCount(); i++ )
-	{
-		FindMacros( obj->GetChild( i ), macros );
-	}
-}
-
-void CppCodeGenerator::FindEventHandlers( PObjectBase obj, EventVector &events )
-{
-	unsigned int i;
-	for ( i = 0; i < obj->GetEventCount(); i++ )
-	{
-		PEvent event = obj->GetEvent( i );
-		if ( !event->GetValue().IsEmpty() )
-			events.push_back( event );
-	}
-
-	for ( i = 0; i < obj->GetChildCount(); i++ )
-	{
-		PObjectBase child = obj->GetChild( i );
-		FindEventHandlers( child, events );
-	}
 }
 
 void CppCodeGenerator::GenDefines( PObjectBase project )
 {
 	std::vector< wxString > macros;
-	FindMacros( project, &macros );
+	FilterMacros( m_analysis->GetMacros(), &macros );
 
 	// Remove the default macro from the set, for backward compatiblity
 	std::vector< wxString >::iterator it;
@@ -1939,7 +1867,7 @@ void CppCodeGenerator::GenEmbeddedBitmapIncludes( PObjectBase project )
 	std::set< wxString > include_set;
 
 	// We begin obtaining the "include" list
-	FindEmbeddedBitmapProperties( project, include_set );
+	FindEmbeddedBitmapProperties( include_set );
 
 	if ( include_set.empty() )
 	{
@@ -1959,56 +1887,42 @@ void CppCodeGenerator::GenEmbeddedBitmapIncludes( PObjectBase project )
 	m_source->WriteLn();
 }
 
-void CppCodeGenerator::FindEmbeddedBitmapProperties( PObjectBase obj, std::set<wxString>& embedset )
+void CppCodeGenerator::FindEmbeddedBitmapProperties( std::set<wxString>& embedset )
 {
-	// We go through (browse) for each property in "obj" object. If any of the
-	// PT_BITMAP type is found, then the proper "include" string is added
-	// in "set". After that, we recursively do it the same with the child objects.
-	unsigned int i, count;
-
-	count = obj->GetPropertyCount();
-
-	for ( i = 0; i < count; i++ )
+	// We go through (browse) each PT_BITMAP property found by the project
+	// analysis, and the proper "include" string is added in "set".
+	const std::vector< PProperty >& bitmaps = m_analysis->GetBitmapProperties();
+	std::vector< PProperty >::const_iterator it;
+	for ( it = bitmaps.begin(); it != bitmaps.end(); ++it )
 	{
-		PProperty property = obj->GetProperty( i );
-		if ( property->GetType() == PT_BITMAP )
-		{
-			wxString propValue = property->GetValue();
+		wxString propValue = ( *it )->GetValue();
 
-			wxString path;
-			wxString source;
-			wxSize icoSize;
-			TypeConv::ParseBitmapWithResource( propValue, &path, &source, &icoSize );
+		wxString path;
+		wxString source;
+		wxSize icoSize;
+		TypeConv::ParseBitmapWithResource( propValue, &path, &source, &icoSize );
 
-			wxFileName bmpFileName( path );
-			if ( bmpFileName.GetExt().Upper() == wxT( "XPM" ) )
-			{
-				wxString absPath = TypeConv::MakeAbsolutePath( path, AppData()->GetProjectPath() );
+		wxFileName bmpFileName( path );
+		if ( bmpFileName.GetExt().Upper() == wxT( "XPM" ) )
+		{
+			wxString absPath = TypeConv::MakeAbsolutePath( path, AppData()->GetProjectPath() );
 
-				// It's supposed that "path" contains an absolut path to the file
-				// and not a relative one.
-				wxString relPath = ( m_useRelativePath ? TypeConv::MakeRelativePath( absPath, m_basePath ) : absPath );
+			// It's supposed that "path" contains an absolut path to the file
+			// and not a relative one.
+			wxString relPath = ( m_useRelativePath ? TypeConv::MakeRelativePath( absPath, m_basePath ) : absPath );
 
-				wxString inc;
-				inc << wxT( "#include \"" ) << relPath << wxT( "\"" );
-				embedset.insert( inc );
-			}
-			else if ( source == _("Load From Embedded File") )
-			{
-				wxString absPath = TypeConv::MakeAbsolutePath( path, AppData()->GetProjectPath() );
-				wxString includePath = FileToCArray::Generate( absPath );
-				wxString inc;
-				inc << wxT( "#include \"" ) << includePath << wxT( "\"" );
-				embedset.insert( inc );
-			}
+			wxString inc;
+			inc << wxT( "#include \"" ) << relPath << wxT( "\"" );
+			embedset.insert( inc );
+		}
+		else if ( source == _("Load From Embedded File") )
+		{
+			wxString absPath = TypeConv::MakeAbsolutePath( path, AppData()->GetProjectPath() );
+			wxString includePath = FileToCArray::Generate( absPath );
+			wxString inc;
+			inc << wxT( "#include \"" ) << includePath << wxT( "\"" );
+			embedset.insert( inc );
 		}
-	}
-
-	count = obj->GetChildCount();
-	for ( i = 0; i < count; i++ )
-	{
-		PObjectBase child = obj->GetChild( i );
-		FindEmbeddedBitmapProperties( child, embedset );
 	}
 }
 
@@ -98,26 +98,16 @@ private:
 	*/
 	wxString GetCode( PObjectBase obj, wxString name);
 
-	/**
-	* Stores the project's objects classes set, for generating the includes.
-	*/
-	void FindDependencies( PObjectBase obj, std::set< PObjectInfo >& info_set );
-
 	/**
 	* Stores the needed "includes" set for the PT_BITMAP properties.
 	*/
-	void FindEmbeddedBitmapProperties( PObjectBase obj, std::set< wxString >& embedset);
+	void FindEmbeddedBitmapProperties( std::set< wxString >& embedset);
 
 	/**
-	* Stores all the properties for "macro" type objects, so that their
-	* related '#define' can be generated subsequently.
+	* Stores the values of "macro" type properties found by the project analysis,
+	* so that their related '#define' can be generated subsequently.
 	*/
-	void FindMacros( PObjectBase obj, std::vector< wxString >* macros );
-
-	/**
-	 * Looks for "non-null" event handlers (PEvent) and collects it into a vector.
-	 */
-	void FindEventHandlers(PObjectBase obj, EventVector &events);
+	void FilterMacros( const std::vector< wxString >& values, std::vector< wxString >* macros );
 
 	/**
 	* Generates classes declarations inside the header file.
@@ -169,7 +159,8 @@ private:
 	* Generate a set of all subclasses to forward declare in the generated header file.
 	* Also generate sets of header files to be include in either the source or header file.
 	*/
-	void GenSubclassSets( PObjectBase obj, std::set< wxString >* subclasses, std::set< wxString >* sourceIncludes, std::vector< wxString >* headerIncludes );
+	void GenSubclassSets( std::set< wxString >* subclasses, std::set< wxString >* sourceIncludes, std::vector< wxString >* headerIncludes );
+	void GenSubclassSet( PObjectBase obj, std::set< wxString >* subclasses, std::set< wxString >* sourceIncludes, std::vector< wxString >* headerIncludes );
 
 	/**
 	* Generates the '#include' section for the embedded bitmap properties.
@@ -229,7 +220,7 @@ public:
 	/**
 	* Convert a wxString to the "C/C++" format.
 	*/
-	static wxString ConvertCppString( wxString text);
+	static wxString ConvertCppString( const wxString& text );
 
 	/**
 	* Convert a path to a relative path.
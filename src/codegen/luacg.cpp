@@ -34,6 +34,7 @@
 #include "model/objectbase.h"
 #include "model/database.h"
 #include "utils/wxfbexception.h"
+#include "utils/trace.h"
 
 #include <algorithm>
 
@@ -385,42 +386,9 @@ LuaCodeGenerator::LuaCodeGenerator()
 	m_strUnsupportedClasses.push_back(wxT("wxDataViewTreeCtrl"));
 }
 
-wxString LuaCodeGenerator::ConvertLuaString( wxString text )
+wxString LuaCodeGenerator::ConvertLuaString( const wxString& text )
 {
-	wxString result;
-
-	for ( size_t i = 0; i < text.length(); i++ )
-	{
-		wxChar c = text[i];
-
-		switch ( c )
-		{
-		case wxT('"'):
-			result += wxT("\\\"");
-			break;
-
-		case wxT('\\'):
-			result += wxT("\\\\");
-			break;
-
-		case wxT('\t'):
-			result += wxT("\\t");
-			break;
-
-		case wxT('\n'):
-			result += wxT("\\n");
-			break;
-
-		case wxT('\r'):
-			result += wxT("\\r");
-			break;
-
-		default:
-			result += c;
-			break;
-		}
-	}
-	return result;
+	return TypeConv::EscapeString( text, true );
 }
 
 void LuaCodeGenerator::GenerateInheritedClass( PObjectBase userClasses, PObjectBase form,const  wxString & genFileFullPath)
@@ -453,7 +421,7 @@ void LuaCodeGenerator::GenerateInheritedClass( PObjectBase userClasses, PObjectB
 
 
 			EventVector events;
-			FindEventHandlers( form, events );
+			ProjectAnalysis::FindEventHandlers( form, &events );
 
 
 			if ( events.size() > 0 )
@@ -536,12 +504,16 @@ wxString LuaCodeGenerator::GenEventEntryForInheritedClass( PObjectBase obj, PObj
 
 bool LuaCodeGenerator::GenerateCode( PObjectBase project )
 {
+	TRACE_SCOPE( "codegen", "LuaCodeGenerator::GenerateCode" );
+
 	if (!project)
 	{
 		wxLogError(wxT("There is no project to generate code"));
 		return false;
 	}
 
+	AnalyzeProject( project );
+
 	m_i18n = false;
 	PProperty i18nProperty = project->GetProperty( wxT("internationalize") );
 	if (i18nProperty && i18nProperty->GetValueAsInteger())
@@ -586,7 +558,7 @@ bool LuaCodeGenerator::GenerateCode( PObjectBase project )
 	std::set< wxString > subclasses;
 	std::vector< wxString > headerIncludes;
 
-	GenSubclassSets( project, &subclasses, &headerIncludes );
+	GenSubclassSets( &subclasses, &headerIncludes );
 
 	// Generating  includes
 	std::set< wxString > templates;
@@ -635,8 +607,7 @@ bool LuaCodeGenerator::GenerateCode( PObjectBase project )
 	{
 		PObjectBase child = project->GetChild( i );
 
-		EventVector events;
-		FindEventHandlers( child, events );
+		const EventVector& events = m_analysis->GetEventHandlers( child );
 		GenClassDeclaration( child, false, wxT(""), events, m_strEventHandlerPostfix );
 	}
 
@@ -911,14 +882,18 @@ void LuaCodeGenerator::GenClassDeclaration(PObjectBase class_obj, bool use_enum,
 
 }
 
-void LuaCodeGenerator::GenSubclassSets( PObjectBase obj, std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes )
+void LuaCodeGenerator::GenSubclassSets( std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes )
 {
-	// Call GenSubclassForwardDeclarations on all children as well
-	for ( unsigned int i = 0; i < obj->GetChildCount(); i++ )
+	// The analysis lists the objects with children before their parents
+	const ObjectBaseVector& objects = m_analysis->GetSubclassedObjects();
+	for ( ObjectBaseVector::const_iterator it = objects.begin(); it != objects.end(); ++it )
 	{
-		GenSubclassSets( obj->GetChild( i ), subclasses, headerIncludes );
+		GenSubclassSet( *it, subclasses, headerIncludes );
 	}
+}
 
+void LuaCodeGenerator::GenSubclassSet( PObjectBase obj, std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes )
+{
 	// Fill the set
 	PProperty subclass = obj->GetProperty( wxT("subclass") );
 	if ( subclass )
@@ -1067,21 +1042,6 @@ void LuaCodeGenerator::AddUniqueIncludes( const wxString& include, std::vector<
 	}
 }
 
-void LuaCodeGenerator::FindDependencies( PObjectBase obj, std::set< PObjectInfo >& info_set )
-{
-	unsigned int ch_count = obj->GetChildCount();
-	if (ch_count > 0)
-	{
-		unsigned int i;
-		for (i = 0; i<ch_count; i++)
-		{
-			PObjectBase child = obj->GetChild(i);
-			info_set.insert(child->GetObjectInfo());
-			FindDependencies(child, info_set);
-		}
-	}
-}
-
 void LuaCodeGenerator::GenConstructor( PObjectBase class_obj, const EventVector &events, wxString &strClassName )
 {
 	PProperty propName = class_obj->GetProperty( wxT("name") );
@@ -1419,60 +1379,30 @@ void LuaCodeGenerator::GenDestruction( PObjectBase obj )
 	}
 }
 
-void LuaCodeGenerator::FindMacros( PObjectBase obj, std::vector<wxString>* macros )
+void LuaCodeGenerator::FilterMacros( const std::vector< wxString >& values, std::vector< wxString >* macros )
 {
-	// iterate through all of the properties of all objects, add the macros
-	// to the vector
-	unsigned int i;
-
-	for ( i = 0; i < obj->GetPropertyCount(); i++ )
+	std::vector< wxString >::const_iterator it;
+	for ( it = values.begin(); it != values.end(); ++it )
 	{
-		PProperty prop = obj->GetProperty( i );
-		if ( prop->GetType() == PT_MACRO )
-		{
-			wxString value = prop->GetValue();
-			if( value.IsEmpty() ) continue;
+		wxString value = *it;
+		if( value.IsEmpty() ) continue;
 
-			// Skip wx IDs
-			if ( ( ! value.Contains( wxT("XRCID" ) ) ) &&
-				 ( m_predMacros.end() == m_predMacros.find( value ) ) )
+		// Skip wx IDs
+		if ( ( ! value.Contains( wxT("XRCID" ) ) ) &&
+			 ( m_predMacros.end() == m_predMacros.find( value ) ) )
+		{
+			if ( macros->end() == std::find( macros->begin(), macros->end(), value ) )
 			{
-				if ( macros->end() == std::find( macros->begin(), macros->end(), value ) )
-				{
-					macros->push_back( value );
-				}
+				macros->push_back( value );
 			}
 		}
 	}
-
-	for ( i = 0; i < obj->GetChildCount(); i++ )
-	{
-		FindMacros( obj->GetChild( i ), macros );
-	}
-}
-
-void LuaCodeGenerator::FindEventHandlers(PObjectBase obj, EventVector &events)
-{
-  unsigned int i;
-  unsigned int evt_cnt = obj->GetEventCount();
-  for (i=0; i < evt_cnt; i++)
-  {
-	PEvent event = obj->GetEvent(i);
-	if (!event->GetValue().IsEmpty())
-	  events.push_back(event);
-  }
-
-  for (i=0; i < obj->GetChildCount(); i++)
-  {
-	PObjectBase child = obj->GetChild(i);
-	FindEventHandlers(child,events);
-  }
 }
 
 void LuaCodeGenerator::GenDefines( PObjectBase project)
 {
 	std::vector< wxString > macros;
-	FindMacros( project, &macros );
+	FilterMacros( m_analysis->GetMacros(), &macros );
 	m_strUserIDsVec.erase(m_strUserIDsVec.begin(),m_strUserIDsVec.end());
 
 	// Remove the default macro from the set, for backward compatiblity
@@ -105,20 +105,10 @@ private:
 	wxString GetCode( PObjectBase obj, wxString name, bool silent = false, wxString strSelf = wxT(""));
 
 	/**
-	* Stores the project's objects classes set, for generating the includes.
+	* Stores the values of "macro" type properties found by the project analysis,
+	* so that their related '#define' can be generated subsequently.
 	*/
-	void FindDependencies( PObjectBase obj, std::set< PObjectInfo >& info_set );
-
-	/**
-	* Stores all the properties for "macro" type objects, so that their
-	* related '#define' can be generated subsequently.
-	*/
-	void FindMacros( PObjectBase obj, std::vector< wxString >* macros );
-
-	/**
-	 * Looks for "non-null" event handlers (PEvent) and collects it into a vector.
-	 */
-	void FindEventHandlers(PObjectBase obj, EventVector &events);
+	void FilterMacros( const std::vector< wxString >& values, std::vector< wxString >* macros );
 
 	/**
 	* Generates classes declarations inside the header file.
@@ -160,7 +150,8 @@ private:
 	/**
 	* Generate a set of all subclasses to forward declare in the generated file.
 	*/
-	void GenSubclassSets( PObjectBase obj, std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes );
+	void GenSubclassSets( std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes );
+	void GenSubclassSet( PObjectBase obj, std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes );
 
 	/**
 	* Generates the '#define' section for macros.
@@ -208,7 +199,7 @@ public:
 	/**
 	* Convert a wxString to the "C/C++" format.
 	*/
-	static wxString ConvertLuaString( wxString text);
+	static wxString ConvertLuaString( const wxString& text );
 
 	LuaCodeGenerator();
 
@@ -34,6 +34,7 @@
 #include "model/objectbase.h"
 #include "model/database.h"
 #include "utils/wxfbexception.h"
+#include "utils/trace.h"
 
 #include <algorithm>
 
@@ -346,42 +347,9 @@ PHPCodeGenerator::PHPCodeGenerator()
 	m_firstID = 1000;
 }
 
-wxString PHPCodeGenerator::ConvertPHPString( wxString text )
+wxString PHPCodeGenerator::ConvertPHPString( const wxString& text )
 {
-	wxString result;
-
-	for ( size_t i = 0; i < text.length(); i++ )
-	{
-		wxChar c = text[i];
-
-		switch ( c )
-		{
-		case wxT('"'):
-			result += wxT("\\\"");
-			break;
-
-		case wxT('\\'):
-			result += wxT("\\\\");
-			break;
-
-		case wxT('\t'):
-			result += wxT("\\t");
-			break;
-
-		case wxT('\n'):
-			result += wxT("\\n");
-			break;
-
-		case wxT('\r'):
-			result += wxT("\\r");
-			break;
-
-		default:
-			result += c;
-			break;
-		}
-	}
-	return result;
+	return TypeConv::EscapeString( text, true );
 }
 
 void PHPCodeGenerator::GenerateInheritedClass( PObjectBase userClasses, PObjectBase form )
@@ -418,7 +386,7 @@ void PHPCodeGenerator::GenerateInheritedClass( PObjectBase userClasses, PObjectB
 
 	// Do events
 	EventVector events;
-	FindEventHandlers( form, events );
+	ProjectAnalysis::FindEventHandlers( form, &events );
 
 	if ( events.size() > 0 )
 	{
@@ -448,12 +416,16 @@ void PHPCodeGenerator::GenerateInheritedClass( PObjectBase userClasses, PObjectB
 
 bool PHPCodeGenerator::GenerateCode( PObjectBase project )
 {
+	TRACE_SCOPE( "codegen", "PHPCodeGenerator::GenerateCode" );
+
 	if (!project)
 	{
 		wxLogError(wxT("There is no project to generate code"));
 		return false;
 	}
 
+	AnalyzeProject( project );
+
 	m_i18n = false;
 	PProperty i18nProperty = project->GetProperty( wxT("internationalize") );
 	if (i18nProperty && i18nProperty->GetValueAsInteger())
@@ -500,7 +472,7 @@ bool PHPCodeGenerator::GenerateCode( PObjectBase project )
 	std::set< wxString > subclasses;
 	std::vector< wxString > headerIncludes;
 
-	GenSubclassSets( project, &subclasses, &headerIncludes );
+	GenSubclassSets( &subclasses, &headerIncludes );
 
 	// Generating in the .h header file those include from components dependencies.
 	std::set< wxString > templates;
@@ -544,8 +516,7 @@ bool PHPCodeGenerator::GenerateCode( PObjectBase project )
 	{
 		PObjectBase child = project->GetChild( i );
 
-		EventVector events;
-		FindEventHandlers( child, events );
+		const EventVector& events = m_analysis->GetEventHandlers( child );
 		//GenClassDeclaration( child, useEnum, classDecoration, events, eventHandlerPrefix, eventHandlerPostfix );
 		GenClassDeclaration( child, false, wxT(""), events, eventHandlerPostfix );
 	}
@@ -800,14 +771,18 @@ void PHPCodeGenerator::GenClassDeclaration(PObjectBase class_obj, bool use_enum,
 	m_source->WriteLn( wxT("") );
 }
 
-void PHPCodeGenerator::GenSubclassSets( PObjectBase obj, std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes )
+void PHPCodeGenerator::GenSubclassSets( std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes )
 {
-	// Call GenSubclassForwardDeclarations on all children as well
-	for ( unsigned int i = 0; i < obj->GetChildCount(); i++ )
+	// The analysis lists the objects with children before their parents
+	const ObjectBaseVector& objects = m_analysis->GetSubclassedObjects();
+	for ( ObjectBaseVector::const_iterator it = objects.begin(); it != objects.end(); ++it )
 	{
-		GenSubclassSets( obj->GetChild( i ), subclasses, headerIncludes );
+		GenSubclassSet( *it, subclasses, headerIncludes );
 	}
+}
 
+void PHPCodeGenerator::GenSubclassSet( PObjectBase obj, std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes )
+{
 	// Fill the set
 	PProperty subclass = obj->GetProperty( wxT("subclass") );
 	if ( subclass )
@@ -959,21 +934,6 @@ void PHPCodeGenerator::AddUniqueIncludes( const wxString& include, std::vector<
 	}
 }
 
-void PHPCodeGenerator::FindDependencies( PObjectBase obj, std::set< PObjectInfo >& info_set )
-{
-	unsigned int ch_count = obj->GetChildCount();
-	if (ch_count > 0)
-	{
-		unsigned int i;
-		for (i = 0; i<ch_count; i++)
-		{
-			PObjectBase child = obj->GetChild(i);
-			info_set.insert(child->GetObjectInfo());
-			FindDependencies(child, info_set);
-		}
-	}
-}
-
 void PHPCodeGenerator::GenConstructor( PObjectBase class_obj, const EventVector &events )
 {
 	m_source->WriteLn();
@@ -1266,59 +1226,30 @@ void PHPCodeGenerator::GenDestruction( PObjectBase obj )
 	}
 }
 
-void PHPCodeGenerator::FindMacros( PObjectBase obj, std::vector<wxString>* macros )
+void PHPCodeGenerator::FilterMacros( const std::vector< wxString >& values, std::vector< wxString >* macros )
 {
-	// iterate through all of the properties of all objects, add the macros
-	// to the vector
-	unsigned int i;
-
-	for ( i = 0; i < obj->GetPropertyCount(); i++ )
+	std::vector< wxString >::const_iterator it;
+	for ( it = values.begin(); it != values.end(); ++it )
 	{
-		PProperty prop = obj->GetProperty( i );
-		if ( prop->GetType() == PT_MACRO )
-		{
-			wxString value = prop->GetValue();
-			if( value.IsEmpty() ) continue;
+		wxString value = *it;
+		if( value.IsEmpty() ) continue;
 
-			// Skip wx IDs
-			if ( ( ! value.Contains( wxT("XRCID" ) ) ) &&
-				 ( m_predMacros.end() == m_predMacros.find( value ) ) )
+		// Skip wx IDs
+		if ( ( ! value.Contains( wxT("XRCID" ) ) ) &&
+			 ( m_predMacros.end() == m_predMacros.find( value ) ) )
+		{
+			if ( macros->end() == std::find( macros->begin(), macros->end(), value ) )
 			{
-				if ( macros->end() == std::find( macros->begin(), macros->end(), value ) )
-				{
-					macros->push_back( value );
-				}
+				macros->push_back( value );
 			}
 		}
 	}
-
-	for ( i = 0; i < obj->GetChildCount(); i++ )
-	{
-		FindMacros( obj->GetChild( i ), macros );
-	}
-}
-
-void PHPCodeGenerator::FindEventHandlers(PObjectBase obj, EventVector &events)
-{
-  unsigned int i;
-  for (i=0; i < obj->GetEventCount(); i++)
-  {
-	PEvent event = obj->GetEvent(i);
-	if (!event->GetValue().IsEmpty())
-	  events.push_back(event);
-  }
-
-  for (i=0; i < obj->GetChildCount(); i++)
-  {
-	PObjectBase child = obj->GetChild(i);
-	FindEventHandlers(child,events);
-  }
 }
 
 void PHPCodeGenerator::GenDefines( PObjectBase project)
 {
 	std::vector< wxString > macros;
-	FindMacros( project, &macros );
+	FilterMacros( m_analysis->GetMacros(), &macros );
 
 	// Remove the default macro from the set, for backward compatiblity
 	std::vector< wxString >::iterator it;
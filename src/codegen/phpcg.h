@@ -101,20 +101,10 @@ private:
 	wxString GetCode( PObjectBase obj, wxString name, bool silent = false);
 
 	/**
-	* Stores the project's objects classes set, for generating the includes.
+	* Stores the values of "macro" type properties found by the project analysis,
+	* so that their related '#define' can be generated subsequently.
 	*/
-	void FindDependencies( PObjectBase obj, std::set< PObjectInfo >& info_set );
-
-	/**
-	* Stores all the properties for "macro" type objects, so that their
-	* related '#define' can be generated subsequently.
-	*/
-	void FindMacros( PObjectBase obj, std::vector< wxString >* macros );
-
-	/**
-	 * Looks for "non-null" event handlers (PEvent) and collects it into a vector.
-	 */
-	void FindEventHandlers(PObjectBase obj, EventVector &events);
+	void FilterMacros( const std::vector< wxString >& values, std::vector< wxString >* macros );
 
 	/**
 	* Generates classes declarations inside the header file.
@@ -151,7 +141,8 @@ private:
 	/**
 	* Generate a set of all subclasses to forward declare in the generated file.
 	*/
-	void GenSubclassSets( PObjectBase obj, std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes );
+	void GenSubclassSets( std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes );
+	void GenSubclassSet( PObjectBase obj, std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes );
 
 	/**
 	* Generates the '#define' section for macros.
@@ -199,7 +190,7 @@ public:
 	/**
 	* Convert a wxString to the "C/C++" format.
 	*/
-	static wxString ConvertPHPString( wxString text);
+	static wxString ConvertPHPString( const wxString& text );
 
 	PHPCodeGenerator();
 
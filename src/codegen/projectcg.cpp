@@ -0,0 +1,264 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "projectcg.h"
+#include "codeanalysis.h"
+#include "codewriter.h"
+#include "cppcg.h"
+#include "pythoncg.h"
+#include "luacg.h"
+#include "phpcg.h"
+#include "xrccg.h"
+#include "model/objectbase.h"
+#include "utils/typeconv.h"
+#include "utils/encodingutils.h"
+#include "utils/wxfbexception.h"
+#include "utils/trace.h"
+
+#include <wx/log.h>
+#include <wx/stopwatch.h>
+
+ProjectCodeGenerator::ProjectCodeGenerator( PObjectBase project, const wxString& path )
+:
+m_project( project ),
+m_path( path ),
+m_useRelativePath( false ),
+m_useMicrosoftBOM( false ),
+m_useUtf8( false ),
+m_convertToAnsi( false ),
+m_hasFirstID( false ),
+m_firstID( 1000 )
+{
+	// Get the file name
+	PProperty pfile = project->GetProperty( wxT( "file" ) );
+	if ( pfile )
+	{
+		m_file = pfile->GetValue();
+	}
+	if ( m_file.empty() )
+	{
+		m_file = wxT("noname");
+	}
+
+	// Get First ID from Project File
+	PProperty pFirstID = project->GetProperty( wxT("first_id") );
+	if ( pFirstID )
+	{
+		m_hasFirstID = true;
+		m_firstID = pFirstID->GetValueAsInteger();
+	}
+
+	// Determine if the path is absolute or relative
+	PProperty pRelPath = project->GetProperty( wxT( "relative_path" ) );
+	if ( pRelPath )
+	{
+		m_useRelativePath = ( pRelPath->GetValueAsInteger() ? true : false );
+	}
+
+	// Determin if Microsoft BOM should be used
+	PProperty pUseMicrosoftBOM = project->GetProperty( wxT( "use_microsoft_bom" ) );
+	if ( pUseMicrosoftBOM )
+	{
+		m_useMicrosoftBOM = ( pUseMicrosoftBOM->GetValueAsInteger() != 0 );
+	}
+
+	// Determine if Utf8 or Ansi is to be created
+	PProperty pUseUtf8 = project->GetProperty( wxT("encoding") );
+	if ( pUseUtf8 )
+	{
+		m_useUtf8 = ( pUseUtf8->GetValueAsString() != wxT("ANSI") );
+		m_convertToAnsi = !m_useUtf8;
+	}
+}
+
+bool ProjectCodeGenerator::GenerateCode()
+{
+	PProperty pCodeGen = m_project->GetProperty( wxT( "code_generation" ) );
+	if ( !pCodeGen )
+	{
+		return true;
+	}
+
+	const wxString languages[] = { wxT("C++"), wxT("Python"), wxT("PHP"), wxT("Lua"), wxT("XRC") };
+
+	bool result = true;
+	for ( size_t i = 0; i < WXSIZEOF( languages ); ++i )
+	{
+		if ( TypeConv::FlagSet( languages[ i ], pCodeGen->GetValue() ) )
+		{
+			result = GenerateCode( languages[ i ] ) && result;
+		}
+	}
+
+	return result;
+}
+
+bool ProjectCodeGenerator::GenerateCode( const wxString& language )
+{
+	TRACE_SCOPE_DETAIL( "codegen", "ProjectCodeGenerator::GenerateCode", language );
+
+	try
+	{
+		wxStopWatch watch;
+		bool generated = false;
+
+		if ( language == wxT("C++") )
+		{
+			generated = GenerateCpp();
+		}
+		else if ( language == wxT("Python") )
+		{
+			generated = GenerateSingleFile( language, wxT( ".py" ) );
+		}
+		else if ( language == wxT("Lua") )
+		{
+			generated = GenerateSingleFile( language, wxT( ".lua" ) );
+		}
+		else if ( language == wxT("PHP") )
+		{
+			generated = GenerateSingleFile( language, wxT( ".php" ) );
+		}
+		else if ( language == wxT("XRC") )
+		{
+			generated = GenerateXrc();
+		}
+		else
+		{
+			THROW_WXFBEX( wxT("Unknown code generation language: ") << language )
+		}
+
+		if ( generated )
+		{
+			wxLogVerbose( wxT( "%s code generated in %ld ms." ), language.c_str(), watch.Time() );
+			wxLogStatus( wxT( "Code generated on \'%s\'." ), m_path.c_str() );
+		}
+		return generated;
+	}
+	catch ( wxFBException& ex )
+	{
+		wxLogError( ex.what() );
+		return false;
+	}
+}
+
+std::shared_ptr< ProjectAnalysis > ProjectCodeGenerator::GetAnalysis()
+{
+	if ( !m_analysis )
+	{
+		m_analysis.reset( new ProjectAnalysis( m_project ) );
+		wxLogVerbose( wxT( "Project analysed in %ld ms." ), m_analysis->GetTime() );
+	}
+	return m_analysis;
+}
+
+bool ProjectCodeGenerator::GenerateCpp()
+{
+	CppCodeGenerator codegen;
+	codegen.SetAnalysis( GetAnalysis() );
+	codegen.UseRelativePath( m_useRelativePath, m_path );
+
+	if ( m_hasFirstID )
+	{
+		codegen.SetFirstID( m_firstID );
+	}
+
+	PCodeWriter h_cw( new FileCodeWriter( m_path + m_file + wxT( ".h" ), m_useMicrosoftBOM, m_useUtf8 ) );
+	PCodeWriter cpp_cw( new FileCodeWriter( m_path + m_file + wxT( ".cpp" ), m_useMicrosoftBOM, m_useUtf8 ) );
+
+	codegen.SetHeaderWriter( h_cw );
+	codegen.SetSourceWriter( cpp_cw );
+	bool result = codegen.GenerateCode( m_project );
+
+	// check if we have to convert to ANSI encoding
+	if ( m_convertToAnsi )
+	{
+		UTF8ToAnsi( m_path + m_file + wxT( ".h" ) );
+		UTF8ToAnsi( m_path + m_file + wxT( ".cpp" ) );
+	}
+
+	return result;
+}
+
+bool ProjectCodeGenerator::GenerateSingleFile( const wxString& language, const wxString& extension )
+{
+	wxString filePath = m_path + m_file + extension;
+	PCodeWriter cw( new FileCodeWriter( filePath, m_useMicrosoftBOM, m_useUtf8 ) );
+
+	bool result = false;
+	if ( language == wxT("Python") )
+	{
+		PythonCodeGenerator codegen;
+		codegen.SetAnalysis( GetAnalysis() );
+		codegen.UseRelativePath( m_useRelativePath, m_path );
+		if ( m_hasFirstID )
+		{
+			codegen.SetFirstID( m_firstID );
+		}
+		codegen.SetSourceWriter( cw );
+		result = codegen.GenerateCode( m_project );
+	}
+	else if ( language == wxT("Lua") )
+	{
+		LuaCodeGenerator codegen;
+		codegen.SetAnalysis( GetAnalysis() );
+		codegen.UseRelativePath( m_useRelativePath, m_path );
+		if ( m_hasFirstID )
+		{
+			codegen.SetFirstID( m_firstID );
+		}
+		codegen.SetSourceWriter( cw );
+		result = codegen.GenerateCode( m_project );
+	}
+	else
+	{
+		PHPCodeGenerator codegen;
+		codegen.SetAnalysis( GetAnalysis() );
+		codegen.UseRelativePath( m_useRelativePath, m_path );
+		if ( m_hasFirstID )
+		{
+			codegen.SetFirstID( m_firstID );
+		}
+		codegen.SetSourceWriter( cw );
+		result = codegen.GenerateCode( m_project );
+	}
+
+	// check if we have to convert to ANSI encoding
+	if ( m_convertToAnsi )
+	{
+		UTF8ToAnsi( filePath );
+	}
+
+	return result;
+}
+
+bool ProjectCodeGenerator::GenerateXrc()
+{
+	XrcCodeGenerator codegen;
+
+	PCodeWriter cw( new FileCodeWriter( m_path + m_file + wxT( ".xrc" ) ) );
+
+	codegen.SetWriter( cw );
+	return codegen.GenerateCode( m_project );
+}
@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _PROJECT_CODE_GEN_
+#define _PROJECT_CODE_GEN_
+
+#include "utils/wxfbdefs.h"
+#include <wx/string.h>
+#include <memory>
+
+class ProjectAnalysis;
+
+/**
+ * Writes the generated files of a project.
+ *
+ * The code panels use it when the user generates the code, and the command
+ * line uses it directly so no window has to be created to generate code.
+ */
+class ProjectCodeGenerator
+{
+private:
+	PObjectBase m_project;
+	wxString m_path;         // output directory, see ApplicationData::GetOutputPath
+	wxString m_file;         // name of the files, without extension
+	bool m_useRelativePath;
+	bool m_useMicrosoftBOM;
+	bool m_useUtf8;
+	bool m_convertToAnsi;
+	bool m_hasFirstID;
+	unsigned int m_firstID;
+	std::shared_ptr< ProjectAnalysis > m_analysis; // shared by the generators of all languages
+
+	std::shared_ptr< ProjectAnalysis > GetAnalysis();
+	bool GenerateCpp();
+	bool GenerateSingleFile( const wxString& language, const wxString& extension );
+	bool GenerateXrc();
+
+public:
+	/**
+	 * @param project Project to generate, the generators may modify it temporarily.
+	 * @param path Output directory, ending with a path separator.
+	 */
+	ProjectCodeGenerator( PObjectBase project, const wxString& path );
+
+	/**
+	 * Reuses an analysis of the project, made by the caller for other generators.
+	 */
+	void SetAnalysis( std::shared_ptr< ProjectAnalysis > analysis ) { m_analysis = analysis; }
+
+	/**
+	 * Generates the files of one language: "C++", "Python", "Lua", "PHP" or "XRC".
+	 * Errors are logged.
+	 * @return false if the files could not be generated.
+	 */
+	bool GenerateCode( const wxString& language );
+
+	/**
+	 * Generates the files of every language set in the code_generation property.
+	 */
+	bool GenerateCode();
+};
+
+#endif //_PROJECT_CODE_GEN_
@@ -34,6 +34,7 @@
 #include "model/objectbase.h"
 #include "model/database.h"
 #include "utils/wxfbexception.h"
+#include "utils/trace.h"
 
 #include <algorithm>
 
@@ -360,42 +361,9 @@ PythonCodeGenerator::PythonCodeGenerator()
 	m_firstID = 1000;
 }
 
-wxString PythonCodeGenerator::ConvertPythonString( wxString text )
+wxString PythonCodeGenerator::ConvertPythonString( const wxString& text )
 {
-	wxString result;
-
-	for ( size_t i = 0; i < text.length(); i++ )
-	{
-		wxChar c = text[i];
-
-		switch ( c )
-		{
-		case wxT('"'):
-			result += wxT("\\\"");
-			break;
-
-		case wxT('\\'):
-			result += wxT("\\\\");
-			break;
-
-		case wxT('\t'):
-			result += wxT("\\t");
-			break;
-
-		case wxT('\n'):
-			result += wxT("\\n");
-			break;
-
-		case wxT('\r'):
-			result += wxT("\\r");
-			break;
-
-		default:
-			result += c;
-			break;
-		}
-	}
-	return result;
+	return TypeConv::EscapeString( text, true );
 }
 
 void PythonCodeGenerator::GenerateInheritedClass( PObjectBase userClasses, PObjectBase form )
@@ -432,7 +400,7 @@ void PythonCodeGenerator::GenerateInheritedClass( PObjectBase userClasses, PObje
 
 	// Do events
 	EventVector events;
-	FindEventHandlers( form, events );
+	ProjectAnalysis::FindEventHandlers( form, &events );
 
 	if ( events.size() > 0 )
 	{
@@ -462,12 +430,16 @@ void PythonCodeGenerator::GenerateInheritedClass( PObjectBase userClasses, PObje
 
 bool PythonCodeGenerator::GenerateCode( PObjectBase project )
 {
+	TRACE_SCOPE( "codegen", "PythonCodeGenerator::GenerateCode" );
+
 	if (!project)
 	{
 		wxLogError(wxT("There is no project to generate code"));
 		return false;
 	}
 
+	AnalyzeProject( project );
+
 	m_i18n = false;
 	PProperty i18nProperty = project->GetProperty( wxT("internationalize") );
 	if (i18nProperty && i18nProperty->GetValueAsInteger())
@@ -514,7 +486,7 @@ bool PythonCodeGenerator::GenerateCode( PObjectBase project )
 	std::set< wxString > subclasses;
 	std::vector< wxString > headerIncludes;
 
-	GenSubclassSets( project, &subclasses, &headerIncludes );
+	GenSubclassSets( &subclasses, &headerIncludes );
 
 	// Generating in the .h header file those include from components dependencies.
 	std::set< wxString > templates;
@@ -558,8 +530,7 @@ bool PythonCodeGenerator::GenerateCode( PObjectBase project )
 	{
 		PObjectBase child = project->GetChild( i );
 
-		EventVector events;
-		FindEventHandlers( child, events );
+		const EventVector& events = m_analysis->GetEventHandlers( child );
 		//GenClassDeclaration( child, useEnum, classDecoration, events, eventHandlerPrefix, eventHandlerPostfix );
 		GenClassDeclaration( child, false, wxT(""), events, eventHandlerPostfix );
 	}
@@ -812,14 +783,18 @@ void PythonCodeGenerator::GenClassDeclaration(PObjectBase class_obj, bool use_en
 	m_source->WriteLn( wxT("") );
 }
 
-void PythonCodeGenerator::GenSubclassSets( PObjectBase obj, std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes )
+void PythonCodeGenerator::GenSubclassSets( std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes )
 {
-	// Call GenSubclassForwardDeclarations on all children as well
-	for ( unsigned int i = 0; i < obj->GetChildCount(); i++ )
+	// The analysis lists the objects with children before their parents
+	const ObjectBaseVector& objects = m_analysis->GetSubclassedObjects();
+	for ( ObjectBaseVector::const_iterator it = objects.begin(); it != objects.end(); ++it )
 	{
-		GenSubclassSets( obj->GetChild( i ), subclasses, headerIncludes );
+		GenSubclassSet( *it, subclasses, headerIncludes );
 	}
+}
 
+void PythonCodeGenerator::GenSubclassSet( PObjectBase obj, std::set< wxString >* subclasses, std::vector< wxString >* headerIncludes )
+{
 	// Fill the set
 	PProperty subclass = obj->GetProperty( wxT("subclass") );
 	if ( subclass )
@@ -971,21 +946,6 @@ void PythonCodeGenerator::AddUniqueIncludes( const wxString& include, std::vecto
 	}
 }
 
-void PythonCodeGenerator::FindDependencies( PObjectBase obj, std::set< PObjectInfo >& info_set )
-{
-	unsigned int ch_count = obj->GetChildCount();
-	if (ch_count > 0)
-	{
-		unsigned int i;
-		for (i = 0; i<ch_count; i++)
-		{
-			PObjectBase child = obj->GetChild(i);
-			info_set.insert(child->GetObjectInfo());
-			FindDependencies(child, info_set);
-		}
-	}
-}
-
 void PythonCodeGenerator::GenConstructor( PObjectBase class_obj, const EventVector &events )
 {
 	m_source->WriteLn();
@@ -1275,62 +1235,32 @@ void PythonCodeGenerator::GenDestruction( PObjectBase obj )
 	}
 }
 
-void PythonCodeGenerator::FindMacros( PObjectBase obj, std::vector<wxString>* macros )
+void PythonCodeGenerator::FilterMacros( const std::vector< wxString >& values, std::vector< wxString >* macros )
 {
-	// iterate through all of the properties of all objects, add the macros
-	// to the vector
-	unsigned int i;
-
-	for ( i = 0; i < obj->GetPropertyCount(); i++ )
+	std::vector< wxString >::const_iterator it;
+	for ( it = values.begin(); it != values.end(); ++it )
 	{
-		PProperty prop = obj->GetProperty( i );
-		if ( prop->GetType() == PT_MACRO )
-		{
-			wxString value = prop->GetValue();
-			if( value.IsEmpty() ) continue;
+		wxString value = *it;
+		if( value.IsEmpty() ) continue;
 
-			//if( value.Contains( wxT("wx") ) && !value.Contains( wxT("wx.") ) ) value.Replace( wxT("wx"), wxT("wx.") );
-			value.Replace( wxT("wx"), wxT("wx.") );
+		value.Replace( wxT("wx"), wxT("wx.") );
 
-			// Skip wx IDs
-			if ( ( ! value.Contains( wxT("XRCID" ) ) ) &&
-				 ( m_predMacros.end() == m_predMacros.find( value ) ) )
+		// Skip wx IDs
+		if ( ( ! value.Contains( wxT("XRCID" ) ) ) &&
+			 ( m_predMacros.end() == m_predMacros.find( value ) ) )
+		{
+			if ( macros->end() == std::find( macros->begin(), macros->end(), value ) )
 			{
-				if ( macros->end() == std::find( macros->begin(), macros->end(), value ) )
-				{
-					macros->push_back( value );
-				}
+				macros->push_back( value );
 			}
 		}
 	}
-
-	for ( i = 0; i < obj->GetChildCount(); i++ )
-	{
-		FindMacros( obj->GetChild( i ), macros );
-	}
-}
-
-void PythonCodeGenerator::FindEventHandlers(PObjectBase obj, EventVector &events)
-{
-  unsigned int i;
-  for (i=0; i < obj->GetEventCount(); i++)
-  {
-	PEvent event = obj->GetEvent(i);
-	if (!event->GetValue().IsEmpty())
-	  events.push_back(event);
-  }
-
-  for (i=0; i < obj->GetChildCount(); i++)
-  {
-	PObjectBase child = obj->GetChild(i);
-	FindEventHandlers(child,events);
-  }
 }
 
 void PythonCodeGenerator::GenDefines( PObjectBase project)
 {
 	std::vector< wxString > macros;
-	FindMacros( project, &macros );
+	FilterMacros( m_analysis->GetMacros(), &macros );
 
 	// Remove the default macro from the set, for backward compatiblity
 	std::vector< wxString >::iterator it;
@@ -27,6 +27,7 @@
 #include "codewriter.h"
 #include "utils/typeconv.h"
 #include "utils/debug.h"
+#include "utils/trace.h"
 #include "model/objectbase.h"
 #include "model/xrcfilter.h"
 
@@ -39,6 +40,8 @@ void XrcCodeGenerator::SetWriter( PCodeWriter cw )
 
 bool XrcCodeGenerator::GenerateCode( PObjectBase project )
 {
+	TRACE_SCOPE( "codegen", "XrcCodeGenerator::GenerateCode" );
+
 	m_cw->Clear();
 	m_contextMenus.clear();
 
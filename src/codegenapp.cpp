@@ -0,0 +1,437 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Command line code generator.
+// Does the same as "wxFormBuilder -g" without initializing the GUI, so it can
+// run where there is no display. With --watch it keeps running and generates
+// the projects again whenever they are saved, with --server it generates the
+// projects sent by "wxfb-codegen --connect".
+
+#include "benchmark.h"
+#include "rad/appdata.h"
+#include "utils/wxfbexception.h"
+#include "utils/wxfbipc.h"
+#include "utils/typeconv.h"
+#include "utils/trace.h"
+
+#include <wx/app.h>
+#include <wx/cmdline.h>
+#include <wx/config.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+#include <wx/stopwatch.h>
+#include <wx/timer.h>
+#if wxUSE_FSWATCHER
+#include <wx/fswatcher.h>
+#endif
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <vector>
+
+static const wxCmdLineEntryDesc s_cmdLineDesc[] =
+{
+	{ wxCMD_LINE_OPTION, "l", "language", "Override the code_generation property from the passed file and generate the passed languages. Separate multiple languages with commas." },
+	{ wxCMD_LINE_SWITCH, "w", "watch",    "Keep running and generate the projects again each time they change." },
+	{ wxCMD_LINE_OPTION, "d", "delay",    "Milliseconds without changes to wait before generating in watch mode (default 300).", wxCMD_LINE_VAL_NUMBER },
+	{ wxCMD_LINE_SWITCH, "s", "server",   "Keep running and generate the projects requested by other wxfb-codegen processes with --connect." },
+	{ wxCMD_LINE_SWITCH, "c", "connect",  "Ask a running server to generate the projects instead of loading wxFormBuilder." },
+	{ wxCMD_LINE_OPTION, NULL, "service", "Name of the code generation service used by --server and --connect." },
+	{ wxCMD_LINE_OPTION, NULL, "timeout", "Seconds to wait for a busy server with --connect (default 600).", wxCMD_LINE_VAL_NUMBER },
+	{ wxCMD_LINE_OPTION, NULL, "benchmark", "Time the loading, saving and code generation of a synthetic project and write the results as JSON to the passed file (- for the standard output)." },
+	{ wxCMD_LINE_OPTION, NULL, "forms",   "Forms of the benchmark project (default 10).", wxCMD_LINE_VAL_NUMBER },
+	{ wxCMD_LINE_OPTION, NULL, "widgets", "Widgets in each form of the benchmark project (default 50).", wxCMD_LINE_VAL_NUMBER },
+	{ wxCMD_LINE_OPTION, NULL, "depth",   "Nested sizers in each form of the benchmark project (default 5).", wxCMD_LINE_VAL_NUMBER },
+	{ wxCMD_LINE_OPTION, NULL, "iterations", "Times each benchmark is repeated (default 5).", wxCMD_LINE_VAL_NUMBER },
+	{ wxCMD_LINE_SWITCH, NULL, "self-test", "Check the string escaping, the code parser and the concurrent project loading on the benchmark project, and exit with a nonzero code if one of them fails." },
+	{ wxCMD_LINE_OPTION, NULL, "data-dir", "Directory with the plugins and the resources of wxFormBuilder, instead of the installed one." },
+	{ wxCMD_LINE_OPTION, NULL, "trace",   "Record how long the main operations take and write them to the passed file, in the Chrome trace event format." },
+	{ wxCMD_LINE_SWITCH, "h", "help",     "Show this help message.", wxCMD_LINE_VAL_STRING, wxCMD_LINE_OPTION_HELP  },
+	{ wxCMD_LINE_PARAM, NULL, NULL,	      "Projects to generate.", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_MULTIPLE | wxCMD_LINE_PARAM_OPTIONAL },
+	{ wxCMD_LINE_NONE }
+};
+
+#if wxUSE_FSWATCHER
+/**
+ * Generates the code of a set of projects each time one of them is written.
+ * The directories are watched instead of the files, so editors that save
+ * by replacing the file are handled as well. Several writes in a row are
+ * merged, the project is generated once they stop for the given delay.
+ */
+class ProjectWatcher : public wxEvtHandler
+{
+private:
+	struct WatchedProject
+	{
+		wxFileName file;
+		wxLongLong firstChange; // 0 when no generation is pending
+		wxLongLong lastChange;
+	};
+
+	std::vector< WatchedProject > m_projects;
+	wxString m_languages;
+	long m_delay;
+	wxFileSystemWatcher* m_watcher;
+	wxTimer m_timer;
+
+	void OnFileSystemEvent( wxFileSystemWatcherEvent& event )
+	{
+		int type = event.GetChangeType();
+		if ( type & ( wxFSW_EVENT_WARNING | wxFSW_EVENT_ERROR ) )
+		{
+			wxLogWarning( wxT("File watcher: %s"), event.GetErrorDescription().c_str() );
+			return;
+		}
+
+		const wxFileName& path = ( type & wxFSW_EVENT_RENAME ? event.GetNewPath() : event.GetPath() );
+
+		wxLongLong now = wxGetLocalTimeMillis();
+		for ( size_t i = 0; i < m_projects.size(); ++i )
+		{
+			WatchedProject& project = m_projects[i];
+			if ( project.file.SameAs( path ) )
+			{
+				if ( project.firstChange == 0 )
+				{
+					project.firstChange = now;
+				}
+				project.lastChange = now;
+				m_timer.Start( m_delay, wxTIMER_ONE_SHOT );
+			}
+		}
+	}
+
+	void OnTimer( wxTimerEvent& )
+	{
+		wxLongLong now = wxGetLocalTimeMillis();
+		long wait = 0;
+
+		for ( size_t i = 0; i < m_projects.size(); ++i )
+		{
+			WatchedProject& project = m_projects[i];
+			if ( project.firstChange == 0 )
+			{
+				continue;
+			}
+
+			long quiet = ( now - project.lastChange ).ToLong();
+			if ( quiet < m_delay )
+			{
+				// Still being written
+				wait = std::max( wait, m_delay - quiet );
+				continue;
+			}
+
+			if ( project.file.FileExists() )
+			{
+				AppData()->GenerateCodeFiles( project.file.GetFullPath(), m_languages );
+				wxLogMessage( _("%s generated %ld ms after it changed."), project.file.GetFullName().c_str(),
+								( wxGetLocalTimeMillis() - project.firstChange ).ToLong() );
+			}
+			project.firstChange = 0;
+		}
+
+		if ( wait > 0 )
+		{
+			m_timer.Start( wait, wxTIMER_ONE_SHOT );
+		}
+	}
+
+public:
+	ProjectWatcher( const wxString& languages, long delay )
+	:
+	m_languages( languages ),
+	m_delay( delay ),
+	m_watcher( NULL )
+	{
+		m_timer.SetOwner( this );
+		Connect( wxEVT_TIMER, wxTimerEventHandler( ProjectWatcher::OnTimer ) );
+		Connect( wxEVT_FSWATCHER, wxFileSystemWatcherEventHandler( ProjectWatcher::OnFileSystemEvent ) );
+	}
+
+	~ProjectWatcher()
+	{
+		m_timer.Stop();
+		delete m_watcher;
+	}
+
+	void AddProject( const wxFileName& file )
+	{
+		WatchedProject project;
+		project.file = file;
+		project.firstChange = 0;
+		project.lastChange = 0;
+		m_projects.push_back( project );
+	}
+
+	/**
+	 * Starts watching, the event loop must be already running.
+	 */
+	bool Start()
+	{
+		m_watcher = new wxFileSystemWatcher();
+		m_watcher->SetOwner( this );
+
+		std::set< wxString > dirs;
+		for ( size_t i = 0; i < m_projects.size(); ++i )
+		{
+			wxString dir = m_projects[i].file.GetPath();
+			if ( !dirs.insert( dir ).second )
+			{
+				continue;
+			}
+
+			if ( !m_watcher->Add( wxFileName::DirName( dir ), wxFSW_EVENT_CREATE | wxFSW_EVENT_MODIFY | wxFSW_EVENT_RENAME ) )
+			{
+				wxLogError( _("Unable to watch directory: %s"), dir.c_str() );
+				return false;
+			}
+		}
+
+		wxLogMessage( _("Watching %lu projects, press Ctrl+C to stop."), (unsigned long)m_projects.size() );
+		return true;
+	}
+};
+#endif
+
+class CodeGenApp : public wxAppConsole
+{
+private:
+	std::unique_ptr< wxFBGenerationIPC > m_server;
+#if wxUSE_FSWATCHER
+	ProjectWatcher* m_watcher;
+#endif
+
+public:
+	int OnRun();
+	int OnExit();
+#if wxUSE_FSWATCHER
+	void OnEventLoopEnter( wxEventLoopBase* loop );
+#endif
+};
+
+IMPLEMENT_APP_CONSOLE( CodeGenApp )
+
+int CodeGenApp::OnRun()
+{
+	wxStopWatch startup;
+
+#if wxUSE_FSWATCHER
+	m_watcher = NULL;
+#endif
+
+	// Same name as the GUI, so the data directory and the settings are shared
+	SetAppName( wxT( " wxFormBuilder" ) );
+	delete wxConfigBase::Set( new wxConfig( wxT("wxFormBuilder") ) );
+
+	wxStandardPathsBase& stdPaths = wxStandardPaths::Get();
+	wxString dataDir = stdPaths.GetDataDir();
+	dataDir.Replace( GetAppName().c_str(), wxT("wxformbuilder") );
+
+	delete wxLog::SetActiveTarget( new wxLogStderr );
+
+	wxCmdLineParser parser( s_cmdLineDesc, argc, argv );
+	if ( 0 != parser.Parse() )
+	{
+		return 1;
+	}
+
+	parser.Found( wxT("data-dir"), &dataDir );
+
+	wxString traceFile;
+	if ( parser.Found( wxT("trace"), &traceFile ) )
+	{
+		Tracer::Start( traceFile );
+	}
+
+	wxString language;
+	if ( parser.Found( wxT("l"), &language ) )
+	{
+		if ( language.empty() )
+		{
+			wxLogError( _("Empty language option. Nothing generated.") );
+			return 3;
+		}
+		language.Replace( wxT(","), wxT("|"), true );
+	}
+
+	std::vector< wxFileName > projects;
+	for ( size_t i = 0; i < parser.GetParamCount(); ++i )
+	{
+		wxFileName projectPath( parser.GetParam( i ) );
+		if ( !projectPath.IsOk() || !projectPath.MakeAbsolute() )
+		{
+			wxLogError( wxT("This path is invalid: %s"), parser.GetParam( i ).c_str() );
+			return 2;
+		}
+		projects.push_back( projectPath );
+	}
+
+	wxString service = wxFBGenerationIPC::GetDefaultService();
+	parser.Found( wxT("service"), &service );
+
+	bool serve = parser.Found( wxT("s") );
+	wxString benchmarkFile;
+	bool benchmark = parser.Found( wxT("benchmark"), &benchmarkFile );
+	bool selfTest = parser.Found( wxT("self-test") );
+
+	if ( projects.empty() && !serve && !benchmark && !selfTest )
+	{
+		wxLogError( _("You must pass a path to a project file. Nothing to generate.") );
+		return 2;
+	}
+
+	// Client mode, the server has everything loaded already
+	if ( parser.Found( wxT("c") ) )
+	{
+		long timeout = 600;
+		parser.Found( wxT("timeout"), &timeout );
+
+		bool submitted = true;
+		for ( size_t i = 0; i < projects.size(); ++i )
+		{
+			wxString reply;
+			bool generated = wxFBGenerationIPC::Submit( service, projects[i].GetFullPath(), language, &reply, timeout * 1000 );
+			wxFprintf( stderr, wxT("%s"), reply.c_str() );
+			submitted = generated && submitted;
+		}
+		return ( submitted ? 0 : 6 );
+	}
+
+	bool watch = parser.Found( wxT("w") );
+#if !wxUSE_FSWATCHER
+	if ( watch )
+	{
+		wxLogError( _("Watch mode is not available, wxWidgets was built without wxFileSystemWatcher.") );
+		return 7;
+	}
+#endif
+
+	AppDataCreate( dataDir );
+
+	try
+	{
+		AppDataInitHeadless();
+	}
+	catch( wxFBException& ex )
+	{
+		wxLogError( _("Error loading application: %s\nwxFormBuilder cannot continue."),	ex.what() );
+		return 5;
+	}
+
+	wxLogMessage( _("Started in %ld ms."), startup.Time() );
+
+	if ( benchmark || selfTest )
+	{
+		long forms = 10, widgets = 50, depth = 5, iterations = ( benchmark ? 5 : 1 );
+		parser.Found( wxT("forms"), &forms );
+		parser.Found( wxT("widgets"), &widgets );
+		parser.Found( wxT("depth"), &depth );
+		parser.Found( wxT("iterations"), &iterations );
+
+		Benchmark::Options options;
+		options.forms = std::max( forms, 0L );
+		options.widgets = std::max( widgets, 0L );
+		options.depth = std::max( depth, 0L );
+		options.iterations = std::max( iterations, 1L );
+
+		Benchmark bench( options );
+		if ( selfTest && !bench.SelfTest() )
+		{
+			return 6;
+		}
+		return ( !benchmark || bench.Run( benchmarkFile ) ? 0 : 6 );
+	}
+
+	bool result = true;
+	for ( size_t i = 0; i < projects.size(); ++i )
+	{
+		result = AppData()->GenerateCodeFiles( projects[i].GetFullPath(), language ) && result;
+	}
+
+	if ( serve )
+	{
+		m_server.reset( new wxFBGenerationIPC );
+		if ( !m_server->CreateServer( service ) )
+		{
+			return 8;
+		}
+		wxLogMessage( _("Serving code generation requests on %s"), service.c_str() );
+	}
+
+#if wxUSE_FSWATCHER
+	if ( watch )
+	{
+		long delay = 300;
+		parser.Found( wxT("d"), &delay );
+
+		// The plugins and the object database stay loaded, generating again only loads the project
+		m_watcher = new ProjectWatcher( language, std::max( delay, 0L ) );
+		for ( size_t i = 0; i < projects.size(); ++i )
+		{
+			m_watcher->AddProject( projects[i] );
+		}
+
+		// Watching starts in OnEventLoopEnter, wxFileSystemWatcher needs a running loop
+		return wxAppConsole::OnRun();
+	}
+#endif
+
+	if ( serve )
+	{
+		// Requests are handled by the event loop one after the other
+		return wxAppConsole::OnRun();
+	}
+
+	return ( result ? 0 : 6 );
+}
+
+#if wxUSE_FSWATCHER
+void CodeGenApp::OnEventLoopEnter( wxEventLoopBase* loop )
+{
+	wxAppConsole::OnEventLoopEnter( loop );
+
+	if ( m_watcher != NULL && loop->IsMain() && !m_watcher->Start() )
+	{
+		ExitMainLoop();
+	}
+}
+#endif
+
+int CodeGenApp::OnExit()
+{
+	Tracer::Stop();
+	m_server.reset();
+#if wxUSE_FSWATCHER
+	delete m_watcher;
+	m_watcher = NULL;
+#endif
+
+	MacroDictionary::Destroy();
+	AppDataDestroy();
+
+	return wxAppConsole::OnExit();
+}
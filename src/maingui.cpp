@@ -34,6 +34,7 @@
 #include <wx/xrc/xmlres.h>
 #include <wx/clipbrd.h>
 #include <wx/msgout.h>
+#include <wx/stopwatch.h>
 #ifdef USE_FLATNOTEBOOK
 #include <wx/wxFlatNotebook/wxFlatNotebook.h>
 #endif
@@ -43,6 +44,7 @@
 
 #include "utils/debug.h"
 #include "utils/typeconv.h"
+#include "utils/trace.h"
 #include "model/objectbase.h"
 
 #if wxVERSION_NUMBER >= 2905
@@ -55,11 +57,13 @@ static const wxCmdLineEntryDesc s_cmdLineDesc[] =
 #if wxVERSION_NUMBER < 2900
 	{ wxCMD_LINE_SWITCH, wxT("g"), wxT("generate"),	wxT("Generate code from passed file.") },
 	{ wxCMD_LINE_OPTION, wxT("l"), wxT("language"),	wxT("Override the code_generation property from the passed file and generate the passed languages. Separate multiple languages with commas.") },
+	{ wxCMD_LINE_OPTION, NULL, wxT("trace"),		wxT("Record how long the main operations take and write them to the passed file, in the Chrome trace event format.") },
 	{ wxCMD_LINE_SWITCH, wxT("h"), wxT("help"),		wxT("Show this help message."), wxCMD_LINE_VAL_STRING, wxCMD_LINE_OPTION_HELP  },
 	{ wxCMD_LINE_PARAM, NULL, NULL,	wxT("File to open."), wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
 #else
     { wxCMD_LINE_SWITCH, "g", "generate", "Generate code from passed file." },
     { wxCMD_LINE_OPTION, "l", "language", "Override the code_generation property from the passed file and generate the passed languages. Separate multiple languages with commas." },
+    { wxCMD_LINE_OPTION, NULL, "trace",   "Record how long the main operations take and write them to the passed file, in the Chrome trace event format." },
     { wxCMD_LINE_SWITCH, "h", "help",     "Show this help message.", wxCMD_LINE_VAL_STRING, wxCMD_LINE_OPTION_HELP  },
     { wxCMD_LINE_PARAM, NULL, NULL,	      "File to open.", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
 #endif
@@ -70,6 +74,8 @@ IMPLEMENT_APP( MyApp )
 
 int MyApp::OnRun()
 {
+	wxStopWatch startup;
+
 	// Using a space so the initial 'w' will not be capitalized in wxLogGUI dialogs
 	wxApp::SetAppName( wxT( " wxFormBuilder" ) );
 
@@ -95,6 +101,12 @@ int MyApp::OnRun()
 		return 1;
 	}
 
+	wxString traceFile;
+	if ( parser.Found( wxT("trace"), &traceFile ) )
+	{
+		Tracer::Start( traceFile );
+	}
+
 	// Get project to load
 	wxString projectToLoad = wxEmptyString;
 	if ( parser.GetParamCount() > 0 )
@@ -161,8 +173,27 @@ int MyApp::OnRun()
 		wxLogError( ex.what() );
 	}
 
+	// Generate the code without creating any window
+	if ( justGenerate )
+	{
+		try
+		{
+			AppDataInitHeadless();
+		}
+		catch( wxFBException& ex )
+		{
+			wxLogError( _("Error loading application: %s\nwxFormBuilder cannot continue."),	ex.what() );
+			wxLog::FlushActive();
+			return 5;
+		}
+
+		wxLogMessage( _("Started in %ld ms."), startup.Time() );
+
+		return ( AppData()->GenerateCodeFiles( projectToLoad, language ) ? 0 : 6 );
+	}
+
 	// If the project is already loaded in another instance, switch to that instance and quit
-	if ( !projectToLoad.empty() && !justGenerate )
+	if ( !projectToLoad.empty() )
 	{
 		if ( ::wxFileExists( projectToLoad ) )
 		{
@@ -200,12 +231,9 @@ int MyApp::OnRun()
 	#ifndef __WXFB_DEBUG__
 	wxBitmap bitmap;
 	std::unique_ptr< cbSplashScreen > splash;
-	if ( !justGenerate )
+	if ( bitmap.LoadFile( dataDir + wxFILE_SEP_PATH + wxT( "resources" ) + wxFILE_SEP_PATH + wxT( "splash.png" ), wxBITMAP_TYPE_PNG ) )
 	{
-		if ( bitmap.LoadFile( dataDir + wxFILE_SEP_PATH + wxT( "resources" ) + wxFILE_SEP_PATH + wxT( "splash.png" ), wxBITMAP_TYPE_PNG ) )
-		{
-			splash = std::unique_ptr< cbSplashScreen >( new cbSplashScreen( bitmap, -1, 0, wxNewId() ) );
-		}
+		splash = std::unique_ptr< cbSplashScreen >( new cbSplashScreen( bitmap, -1, 0, wxNewId() ) );
 	}
 	#endif
 
@@ -230,24 +258,21 @@ int MyApp::OnRun()
 	config->SetPath( wxT("/") );
 
 	m_frame = new MainFrame( NULL ,-1, (int)style, wxPoint( x, y ), wxSize( w, h ) );
-	if ( !justGenerate )
-	{
-		m_frame->Show( TRUE );
-		SetTopWindow( m_frame );
+	m_frame->Show( TRUE );
+	SetTopWindow( m_frame );
 
-		#ifndef __WXFB_DEBUG__
-		// turn off the splash screen
-		delete splash.release();
-		#endif
+	#ifndef __WXFB_DEBUG__
+	// turn off the splash screen
+	delete splash.release();
+	#endif
 
-		#ifdef __WXFB_DEBUG__
-			wxLogWindow* log = dynamic_cast< wxLogWindow* >( AppData()->GetDebugLogTarget() );
-			if ( log )
-			{
-				m_frame->AddChild( log->GetFrame() );
-			}
-		#endif //__WXFB_DEBUG__
-	}
+	#ifdef __WXFB_DEBUG__
+		wxLogWindow* log = dynamic_cast< wxLogWindow* >( AppData()->GetDebugLogTarget() );
+		if ( log )
+		{
+			m_frame->AddChild( log->GetFrame() );
+		}
+	#endif //__WXFB_DEBUG__
 
 	// This is not necessary for wxFB to work. However, Windows sets the Current Working Directory
 	// to the directory from which a .fbp file was opened, if opened from Windows Explorer.
@@ -259,27 +284,10 @@ int MyApp::OnRun()
 
 	if ( !projectToLoad.empty() )
 	{
-		if ( AppData()->LoadProject( projectToLoad, justGenerate ) )
+		if ( AppData()->LoadProject( projectToLoad ) )
 		{
-			if ( justGenerate )
-			{
-				if ( hasLanguage )
-				{
-					PObjectBase project = AppData()->GetProjectData();
-					PProperty codeGen = project->GetProperty( _("code_generation") );
-					if ( codeGen )
-					{
-						codeGen->SetValue( language );
-					}
-				}
-				AppData()->GenerateCode( false, true );
-				return 0;
-			}
-			else
-			{
-				m_frame->InsertRecentProject( projectToLoad );
-				return wxApp::OnRun();
-			}
+			m_frame->InsertRecentProject( projectToLoad );
+			return wxApp::OnRun();
 		}
 		else
 		{
@@ -287,11 +295,6 @@ int MyApp::OnRun()
 		}
 	}
 
-	if ( justGenerate )
-	{
-		return 6;
-	}
-
 	AppData()->NewProject();
 
 #ifdef __WXMAC__
@@ -314,7 +317,9 @@ bool MyApp::OnInit()
 
 int MyApp::OnExit()
 {
+	Tracer::Stop();
 	MacroDictionary::Destroy();
+	TypeConv::ClearBitmapCache();
 #ifdef USE_FLATNOTEBOOK
 	wxFlatNotebook::CleanUp();
 #endif
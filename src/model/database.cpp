@@ -39,6 +39,15 @@
 #include <wx/tokenzr.h>
 #include <wx/stdpaths.h>
 #include <wx/app.h>
+#include <wx/file.h>
+#include <wx/mstream.h>
+#include <wx/stopwatch.h>
+#include "md5/md5.hh"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
 
 //#define DEBUG_PRINT(x) cout << x
 
@@ -63,6 +72,32 @@
 #define EXPANDED_TAG "expanded"
 #define WXVERSION_TAG "wxversion"
 
+namespace
+{
+	/**
+	 * Objects created by a thread while loading a project.
+	 * The instance counters of the classes are shared, so the thread counts on
+	 * its own, and the default names get their final number once the counts of
+	 * the previous forms are known.
+	 */
+	struct LoadContext
+	{
+		struct DefaultName
+		{
+			PProperty property;
+			PObjectInfo info;
+			wxString base;        // default name, without the number
+			unsigned int count;   // number of the instance in this context
+			bool loaded;          // the project sets the name
+		};
+
+		std::map< ObjectInfo*, unsigned int > counts;
+		std::vector< DefaultName > names;
+	};
+
+	thread_local LoadContext* s_loadContext = NULL;
+}
+
 
 #ifdef __WXMAC__
 #include <dlfcn.h>
@@ -89,7 +124,12 @@ void ObjectPackage::AppendPackage( PObjectPackage package )
 ///////////////////////////////////////////////////////////////////////////////
 
 ObjectDatabase::ObjectDatabase()
+:
+m_loadIcons( true ),
+m_concurrentLoad( true )
 {
+	m_iconStats.icons = m_iconStats.fromCache = m_iconStats.threads = 0;
+	m_iconStats.milliseconds = 0;
 	//InitObjectTypes();
 	//  InitWidgetTypes();
 	InitPropertyTypes();
@@ -207,12 +247,27 @@ PObjectBase ObjectDatabase::NewObject(PObjectInfo obj_info)
 	// si el objeto tiene la propiedad name (reservada para el nombre del
 	// objeto) le añadimos el contador para no repetir nombres.
 
-	obj_info->IncrementInstanceCount();
+	unsigned int ins;
+	if ( s_loadContext )
+	{
+		ins = ++s_loadContext->counts[ obj_info.get() ];
+	}
+	else
+	{
+		obj_info->IncrementInstanceCount();
+		ins = obj_info->GetInstanceCount();
+	}
 
-	unsigned int ins = obj_info->GetInstanceCount();
 	PProperty pname = object->GetProperty( wxT(NAME_TAG) );
 	if (pname)
+	{
+		if ( s_loadContext )
+		{
+			LoadContext::DefaultName name = { pname, obj_info, pname->GetValue(), ins, false };
+			s_loadContext->names.push_back( name );
+		}
 		pname->SetValue(pname->GetValue() + StringUtils::IntToStr(ins));
+	}
 
 	return object;
 }
@@ -496,6 +551,7 @@ PObjectBase ObjectDatabase::CreateObject( ticpp::Element* xml_obj, PObjectBase p
 		std::string class_name;
 		xml_obj->GetAttribute( CLASS_TAG, &class_name, false );
 
+		size_t firstName = ( s_loadContext ? s_loadContext->names.size() : 0 );
 		PObjectBase newobject = CreateObject( class_name, parent );
 
 		// It is possible the CreateObject returns an "item" containing the object, e.g. SizerItem or SplitterItem
@@ -525,6 +581,17 @@ PObjectBase ObjectDatabase::CreateObject( ticpp::Element* xml_obj, PObjectBase p
 				{
 					// load the value
 					prop->SetValue( _WXSTR( xml_prop->GetText( false ) ) );
+
+					if ( s_loadContext && prop_name == NAME_TAG )
+					{
+						for ( size_t i = firstName; i < s_loadContext->names.size(); ++i )
+						{
+							if ( s_loadContext->names[i].property == prop )
+							{
+								s_loadContext->names[i].loaded = true;
+							}
+						}
+					}
 				}
 				else
 				{
@@ -566,11 +633,14 @@ PObjectBase ObjectDatabase::CreateObject( ticpp::Element* xml_obj, PObjectBase p
 			}
 
 			// create the children
-			ticpp::Element* child = xml_obj->FirstChildElement( OBJECT_TAG, false );
-			while ( child )
+			if ( !CreateChildrenConcurrently( object, xml_obj ) )
 			{
-				CreateObject( child, object );
-				child = child->NextSiblingElement( OBJECT_TAG, false );
+				ticpp::Element* child = xml_obj->FirstChildElement( OBJECT_TAG, false );
+				while ( child )
+				{
+					CreateObject( child, object );
+					child = child->NextSiblingElement( OBJECT_TAG, false );
+				}
 			}
 		}
 
@@ -582,6 +652,127 @@ PObjectBase ObjectDatabase::CreateObject( ticpp::Element* xml_obj, PObjectBase p
 	}
 }
 
+bool ObjectDatabase::CreateChildrenConcurrently( PObjectBase parent, ticpp::Element* xml_parent )
+{
+#if wxVERSION_NUMBER < 2900
+	// wxString copies share their buffer without atomic reference counting
+	return false;
+#else
+	if ( !m_concurrentLoad || s_loadContext != NULL || parent->GetObjectTypeName() != wxT("project") )
+	{
+		return false;
+	}
+
+	// Only if every form would be created directly under the project, the
+	// checks that depend on the other children can't be done concurrently
+	PObjectType parentType = parent->GetObjectInfo()->GetObjectType();
+	std::vector< ticpp::Element* > children;
+	ticpp::Element* child = xml_parent->FirstChildElement( OBJECT_TAG, false );
+	while ( child )
+	{
+		std::string class_name;
+		child->GetAttribute( CLASS_TAG, &class_name, false );
+
+		PObjectInfo info = GetObjectInfo( _WXSTR(class_name) );
+		if ( !info || parentType->FindChildType( info->GetObjectType(), false ) >= 0 )
+		{
+			return false;
+		}
+
+		children.push_back( child );
+		child = child->NextSiblingElement( OBJECT_TAG, false );
+	}
+
+	size_t workerCount = std::max( 1u, std::thread::hardware_concurrency() );
+	workerCount = std::min( workerCount, children.size() );
+	if ( workerCount < 2 )
+	{
+		return false;
+	}
+
+	// Each worker creates a range of consecutive forms, so the ranges can be
+	// numbered in order afterwards
+	struct Job
+	{
+		size_t first;
+		size_t last;
+		LoadContext context;
+		std::vector< PObjectBase > objects;
+		std::exception_ptr error;
+	};
+
+	std::vector< Job > jobs( workerCount );
+	std::vector< std::thread > workers;
+	for ( size_t i = 0; i < workerCount; ++i )
+	{
+		Job& job = jobs[i];
+		job.first = children.size() * i / workerCount;
+		job.last = children.size() * ( i + 1 ) / workerCount;
+
+		workers.push_back( std::thread( [ this, &job, &children ]()
+		{
+			s_loadContext = &job.context;
+			try
+			{
+				for ( size_t c = job.first; c < job.last; ++c )
+				{
+					job.objects.push_back( CreateObject( children[c] ) );
+				}
+			}
+			catch ( ... )
+			{
+				job.error = std::current_exception();
+			}
+			s_loadContext = NULL;
+		} ) );
+	}
+
+	for ( std::vector< std::thread >::iterator worker = workers.begin(); worker != workers.end(); ++worker )
+	{
+		worker->join();
+	}
+
+	// Number the default names and link the forms as if they had been created
+	// one after the other
+	for ( size_t i = 0; i < jobs.size(); ++i )
+	{
+		Job& job = jobs[i];
+
+		std::vector< LoadContext::DefaultName >& names = job.context.names;
+		for ( std::vector< LoadContext::DefaultName >::iterator name = names.begin(); name != names.end(); ++name )
+		{
+			if ( !name->loaded )
+			{
+				name->property->SetValue( name->base + StringUtils::IntToStr( name->info->GetInstanceCount() + name->count ) );
+			}
+		}
+
+		std::map< ObjectInfo*, unsigned int >& counts = job.context.counts;
+		for ( std::map< ObjectInfo*, unsigned int >::iterator count = counts.begin(); count != counts.end(); ++count )
+		{
+			count->first->AddInstanceCount( count->second );
+		}
+
+		for ( std::vector< PObjectBase >::iterator object = job.objects.begin(); object != job.objects.end(); ++object )
+		{
+			if ( *object )
+			{
+				parent->AddChild( *object );
+				( *object )->SetParent( parent );
+			}
+		}
+
+		// The forms after the failing one would not have been created
+		if ( job.error )
+		{
+			std::rethrow_exception( job.error );
+		}
+	}
+
+	return true;
+#endif
+}
+
 //////////////////////////////
 
 bool IncludeInPalette(wxString type)
@@ -591,6 +782,8 @@ bool IncludeInPalette(wxString type)
 
 void ObjectDatabase::LoadPlugins( PwxFBManager manager )
 {
+	m_manager = manager;
+
 	// Load some default templates
 	LoadCodeGen( m_xmlPath + wxT("properties.cppcode") );
 	LoadCodeGen( m_xmlPath + wxT("properties.pythoncode") );
@@ -741,6 +934,57 @@ void ObjectDatabase::LoadPlugins( PwxFBManager manager )
     {
     	m_pkgs.push_back( packageIt->second );
     }
+
+	// All the classes are known now
+	BuildClassHierarchy();
+}
+
+void ObjectDatabase::BuildClassHierarchy()
+{
+	// Index every class, including base classes that are not in the map
+	std::vector< PObjectInfo > classes;
+	std::shared_ptr< ClassIndexMap > classIndex( new ClassIndexMap );
+	std::map< ObjectInfo*, int > indexes;
+
+	std::vector< PObjectInfo > pending;
+	for ( std::map< wxString, PObjectInfo >::iterator it = m_objs.begin(); it != m_objs.end(); ++it )
+	{
+		pending.push_back( it->second );
+	}
+
+	while ( !pending.empty() )
+	{
+		PObjectInfo info = pending.back();
+		pending.pop_back();
+
+		if ( !indexes.insert( std::make_pair( info.get(), (int)classes.size() ) ).second )
+		{
+			continue;
+		}
+
+		( *classIndex )[ info->GetClassName() ] = (int)classes.size();
+		classes.push_back( info );
+
+		for ( unsigned int i = 0; i < info->GetBaseClassCount( false ); ++i )
+		{
+			pending.push_back( info->GetBaseClass( i, false ) );
+		}
+	}
+
+	for ( size_t i = 0; i < classes.size(); ++i )
+	{
+		std::vector< bool > ancestors( classes.size(), false );
+		ancestors[i] = true;
+
+		std::vector< PObjectInfo > bases;
+		classes[i]->GetBaseClasses( bases );
+		for ( std::vector< PObjectInfo >::iterator base = bases.begin(); base != bases.end(); ++base )
+		{
+			ancestors[ indexes[ base->get() ] ] = true;
+		}
+
+		classes[i]->SetClassHierarchy( (int)i, ancestors, bases, classIndex );
+	}
 }
 
 void ObjectDatabase::SetupPackage( const wxString& file, const wxString& path, PwxFBManager manager )
@@ -779,26 +1023,12 @@ void ObjectDatabase::SetupPackage( const wxString& file, const wxString& path, P
 		root->GetAttributeOrDefault( "lib", &lib, "" );
 		if ( !lib.empty() )
 		{
-			// Allows plugin dependency dlls to be next to plugin dll in windows
-			wxString workingDir = ::wxGetCwd();
-			wxFileName::SetCwd( libPath );
-			try
-			{
-				wxString fullLibPath = libPath + wxFILE_SEP_PATH + _WXSTR(lib) + wxver;
-				if ( m_importedLibraries.insert( fullLibPath ).second )
-				{
-					ImportComponentLibrary( fullLibPath, manager );
-				}
-			}
-			catch ( ... )
+			// The library is imported when one of its components is needed
+			wxString fullLibPath = libPath + wxFILE_SEP_PATH + _WXSTR(lib) + wxver;
+			if ( m_importedLibraries.insert( fullLibPath ).second )
 			{
-				// Put Cwd back
-				wxFileName::SetCwd( workingDir );
-				throw;
+				m_pendingLibraries.push_back( std::make_pair( fullLibPath, libPath ) );
 			}
-
-			// Put Cwd back
-			wxFileName::SetCwd( workingDir );
 		}
 
 		ticpp::Element* elem_obj = root->FirstChildElement( OBJINFO_TAG, false );
@@ -822,6 +1052,11 @@ void ObjectDatabase::SetupPackage( const wxString& file, const wxString& path, P
 
 			PObjectInfo class_info = GetObjectInfo( _WXSTR(class_name) );
 
+			if ( class_info && !lib.empty() )
+			{
+				class_info->SetComponentLibrary( this );
+			}
+
 			ticpp::Element* elem_base = elem_obj->FirstChildElement( "inherits", false );
 			while ( elem_base )
 			{
@@ -997,6 +1232,261 @@ void ObjectDatabase::LoadCodeGen( const wxString& file )
 	}
 }
 
+// An icon file decoded and scaled to one size, by a worker thread of LoadIcons
+struct IconJob
+{
+	wxString source;
+	int size;
+	std::vector< unsigned char > data;  // content of the source file
+	wxString hash;                      // MD5 of the content, empty if it could not be read
+	size_t decodedBy;                   // job that decodes the same content and size
+	wxImage image;
+	bool cached;
+};
+
+// Runs the job function on each job, with a pool of threads
+static size_t RunIconJobs( std::vector< IconJob >& jobs, const std::vector< size_t >& indexes, std::function< void( IconJob& ) > function )
+{
+#if wxVERSION_NUMBER < 2900
+	// The jobs build wxStrings and wxImages, whose copies share their buffer
+	// without atomic reference counting, so they are run in this thread
+	for ( std::vector< size_t >::const_iterator job = indexes.begin(); job != indexes.end(); ++job )
+	{
+		function( jobs[ *job ] );
+	}
+
+	return 1;
+#else
+	size_t workerCount = std::max( 1u, std::thread::hardware_concurrency() );
+	workerCount = std::min( workerCount, indexes.size() );
+
+	std::atomic< size_t > next( 0 );
+	std::vector< std::thread > workers;
+	for ( size_t i = 0; i < workerCount; ++i )
+	{
+		workers.push_back( std::thread( [ &jobs, &indexes, &next, &function ]()
+		{
+			// Logging is enabled per thread, broken icons or cache files are not reported
+			wxLogNull stopLogging;
+			for ( size_t job = next++; job < indexes.size(); job = next++ )
+			{
+				function( jobs[ indexes[ job ] ] );
+			}
+		} ) );
+	}
+	for ( std::vector< std::thread >::iterator worker = workers.begin(); worker != workers.end(); ++worker )
+	{
+		worker->join();
+	}
+
+	return workerCount;
+#endif
+}
+
+// Reads the source file, so the jobs with the same content can be decoded only once
+static void ReadIcon( IconJob& job )
+{
+	wxFile file( job.source );
+	if ( !file.IsOpened() )
+	{
+		return;
+	}
+
+	wxFileOffset length = file.Length();
+	if ( length <= 0 )
+	{
+		return;
+	}
+
+	job.data.resize( (size_t)length );
+	if ( file.Read( &job.data[0], job.data.size() ) != (ssize_t)job.data.size() )
+	{
+		job.data.clear();
+		return;
+	}
+
+	MD5 hash;
+	hash.update( &job.data[0], (unsigned int)job.data.size() );
+	hash.finalize();
+	char* digest = hash.hex_digest();
+	job.hash = wxString::FromAscii( digest );
+	delete [] digest;
+}
+
+// Only uses wxImage, which can be used out of the GUI thread.
+// The scaled icons are kept in cachePath (if not empty), named by the MD5 of the
+// source file and the size, so the next startup only has to read a small PNG.
+static void DecodeIcon( IconJob& job, const wxString& cachePath )
+{
+	job.cached = false;
+
+	wxString cacheFile;
+	if ( !cachePath.empty() )
+	{
+		cacheFile = cachePath + wxFILE_SEP_PATH + job.hash + wxString::Format( wxT("_%i.png"), job.size );
+
+		if ( wxFileName::FileExists( cacheFile ) )
+		{
+			wxImage cached;
+			if ( cached.LoadFile( cacheFile, wxBITMAP_TYPE_PNG ) && cached.GetWidth() == job.size && cached.GetHeight() == job.size )
+			{
+				job.image = cached;
+				job.cached = true;
+				return;
+			}
+		}
+	}
+
+	wxMemoryInputStream stream( &job.data[0], job.data.size() );
+	wxImage img( stream, wxBITMAP_TYPE_ANY );
+	if ( !img.IsOk() )
+	{
+		return;
+	}
+
+	job.image = img.Scale( job.size, job.size );
+
+	if ( !cacheFile.empty() )
+	{
+		// Written aside and renamed, so an interrupted write or another instance of
+		// wxFormBuilder starting at the same time never leaves a partial file behind
+		wxString tempFile = cacheFile + wxString::Format( wxT(".%lu.tmp"), ::wxGetProcessId() );
+		if ( !job.image.SaveFile( tempFile, wxBITMAP_TYPE_PNG ) || !wxRenameFile( tempFile, cacheFile ) )
+		{
+			wxRemoveFile( tempFile );
+		}
+	}
+}
+
+void ObjectDatabase::LoadIcons()
+{
+	if ( m_iconRequests.empty() )
+	{
+		return;
+	}
+
+	wxStopWatch watch;
+
+	wxString cachePath = m_iconCachePath;
+	if ( !cachePath.empty() && !wxFileName::DirExists( cachePath ) && !wxFileName::Mkdir( cachePath, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+	{
+		cachePath.clear();
+	}
+
+	// Each file is decoded only once per size, even if several classes use it
+	typedef std::map< std::pair< wxString, int >, size_t > JobMap;
+	JobMap jobIndex;
+	std::vector< IconJob > jobs;
+
+	for ( std::vector< IconRequest >::iterator request = m_iconRequests.begin(); request != m_iconRequests.end(); ++request )
+	{
+		std::pair< wxString, int > keys[] = { std::make_pair( request->icon, ICON_SIZE ), std::make_pair( request->smallIcon, SMALL_ICON_SIZE ) };
+		for ( size_t i = 0; i < WXSIZEOF( keys ); ++i )
+		{
+			if ( !keys[i].first.empty() && jobIndex.insert( JobMap::value_type( keys[i], jobs.size() ) ).second )
+			{
+				IconJob job;
+				job.source = keys[i].first;
+				job.size = keys[i].second;
+				job.decodedBy = jobs.size();
+				job.cached = false;
+				jobs.push_back( job );
+			}
+		}
+	}
+
+	#if wxVERSION_NUMBER < 2900
+	// The jobs run in this thread, broken icons or cache files are not reported
+	wxLogNull stopLogging;
+	#endif
+
+	std::vector< size_t > all;
+	for ( size_t i = 0; i < jobs.size(); ++i )
+	{
+		all.push_back( i );
+	}
+	size_t workerCount = RunIconJobs( jobs, all, ReadIcon );
+
+	// Different files with the same content, like copies of a generic icon, share a
+	// single job, so no two threads write or read the same cache file
+	typedef std::map< std::pair< wxString, int >, size_t > HashMap;
+	HashMap hashIndex;
+	std::vector< size_t > unique;
+	for ( size_t i = 0; i < jobs.size(); ++i )
+	{
+		if ( jobs[i].hash.empty() )
+		{
+			continue;
+		}
+
+		std::pair< HashMap::iterator, bool > first = hashIndex.insert( HashMap::value_type( std::make_pair( jobs[i].hash, jobs[i].size ), i ) );
+		if ( first.second )
+		{
+			unique.push_back( i );
+		}
+		jobs[i].decodedBy = first.first->second;
+	}
+
+	RunIconJobs( jobs, unique, [ &cachePath ]( IconJob& job )
+	{
+		DecodeIcon( job, cachePath );
+		job.data.clear();
+	} );
+
+	// wxBitmap must be created in the GUI thread
+	std::vector< wxBitmap > bitmaps( jobs.size() );
+	size_t fromCache = 0;
+	for ( size_t i = 0; i < jobs.size(); ++i )
+	{
+		const IconJob& decoded = jobs[ jobs[i].decodedBy ];
+		if ( jobs[i].decodedBy != i )
+		{
+			bitmaps[i] = bitmaps[ jobs[i].decodedBy ];
+		}
+		else if ( decoded.image.IsOk() )
+		{
+			bitmaps[i] = wxBitmap( decoded.image );
+		}
+		if ( decoded.cached )
+		{
+			++fromCache;
+		}
+	}
+
+	for ( std::vector< IconRequest >::iterator request = m_iconRequests.begin(); request != m_iconRequests.end(); ++request )
+	{
+		JobMap::iterator icon = jobIndex.find( std::make_pair( request->icon, (int)ICON_SIZE ) );
+		if ( icon != jobIndex.end() && bitmaps[ icon->second ].IsOk() )
+		{
+			request->info->SetIconFile( bitmaps[ icon->second ] );
+		}
+		else
+		{
+			request->info->SetIconFile( AppBitmaps::GetBitmap( wxT("unknown"), ICON_SIZE ) );
+		}
+
+		JobMap::iterator smallIcon = jobIndex.find( std::make_pair( request->smallIcon, (int)SMALL_ICON_SIZE ) );
+		if ( smallIcon != jobIndex.end() && bitmaps[ smallIcon->second ].IsOk() )
+		{
+			request->info->SetSmallIconFile( bitmaps[ smallIcon->second ] );
+		}
+		else
+		{
+			wxImage img = request->info->GetIconFile().ConvertToImage();
+			request->info->SetSmallIconFile( wxBitmap( img.Scale( SMALL_ICON_SIZE, SMALL_ICON_SIZE ) ) );
+		}
+	}
+
+	m_iconStats.icons = (unsigned int)jobs.size();
+	m_iconStats.fromCache = (unsigned int)fromCache;
+	m_iconStats.threads = (unsigned int)workerCount;
+	m_iconStats.milliseconds = watch.Time();
+
+	wxLogVerbose( wxT("Loaded %u icons in %ld ms with %u threads, %u from the cache"), m_iconStats.icons, m_iconStats.milliseconds, m_iconStats.threads, m_iconStats.fromCache );
+
+	m_iconRequests.clear();
+}
+
 PObjectPackage ObjectDatabase::LoadPackage( const wxString& file, const wxString& iconPath )
 {
 	PObjectPackage package;
@@ -1022,7 +1512,11 @@ PObjectPackage ObjectDatabase::LoadPackage( const wxString& file, const wxString
 		wxString pkgIconPath = iconPath + wxFILE_SEP_PATH +  _WXSTR(pkgIconName);
 
 		wxBitmap pkg_icon;
-		if ( !pkgIconName.empty() && wxFileName::FileExists( pkgIconPath ) )
+		if ( !m_loadIcons )
+		{
+			// No palette without GUI
+		}
+		else if ( !pkgIconName.empty() && wxFileName::FileExists( pkgIconPath ) )
 		{
 			wxImage image( pkgIconPath, wxBITMAP_TYPE_ANY );
 			pkg_icon = wxBitmap( image.Scale( 16, 16 ) );
@@ -1071,25 +1565,20 @@ PObjectPackage ObjectDatabase::LoadPackage( const wxString& file, const wxString
 
 			PObjectInfo obj_info( new ObjectInfo( _WXSTR(class_name), GetObjectType( _WXSTR(type) ), package, startGroup ) );
 
-			if ( !icon.empty() && wxFileName::FileExists( iconFullPath ) )
+			if ( m_loadIcons )
 			{
-				wxImage img( iconFullPath, wxBITMAP_TYPE_ANY );
-				obj_info->SetIconFile( wxBitmap( img.Scale( ICON_SIZE, ICON_SIZE ) ) );
-			}
-			else
-			{
-				obj_info->SetIconFile( AppBitmaps::GetBitmap( wxT("unknown"), ICON_SIZE ) );
-			}
-
-			if ( !smallIcon.empty() && wxFileName::FileExists( smallIconFullPath ) )
-			{
-				wxImage img( smallIconFullPath, wxBITMAP_TYPE_ANY );
-				obj_info->SetSmallIconFile( wxBitmap( img.Scale( SMALL_ICON_SIZE, SMALL_ICON_SIZE ) ) );
-			}
-			else
-			{
-				wxImage img = obj_info->GetIconFile().ConvertToImage();
-				obj_info->SetSmallIconFile( wxBitmap( img.Scale( SMALL_ICON_SIZE, SMALL_ICON_SIZE ) ) );
+				// Decoded later, all at once, by LoadIcons
+				IconRequest request;
+				request.info = obj_info;
+				if ( !icon.empty() && wxFileName::FileExists( iconFullPath ) )
+				{
+					request.icon = iconFullPath;
+				}
+				if ( !smallIcon.empty() && wxFileName::FileExists( smallIconFullPath ) )
+				{
+					request.smallIcon = smallIconFullPath;
+				}
+				m_iconRequests.push_back( request );
 			}
 
 			// Parse the Properties
@@ -1374,6 +1863,41 @@ bool ObjectDatabase::ShowInPalette(wxString type)
 }
 
 
+void ObjectDatabase::ImportComponentLibraries()
+{
+	if ( m_pendingLibraries.empty() )
+	{
+		return;
+	}
+
+	// All of them are imported at once, a library may use the macros registered by another one
+	std::vector< std::pair< wxString, wxString > > libraries;
+	libraries.swap( m_pendingLibraries );
+
+	for ( std::vector< std::pair< wxString, wxString > >::iterator lib = libraries.begin(); lib != libraries.end(); ++lib )
+	{
+		// Allows plugin dependency dlls to be next to plugin dll in windows
+		wxString workingDir = ::wxGetCwd();
+		wxFileName::SetCwd( lib->second );
+		try
+		{
+			ImportComponentLibrary( lib->first, m_manager );
+		}
+		catch ( wxFBException& ex )
+		{
+			wxLogError( ex.what() );
+		}
+
+		// Put Cwd back
+		wxFileName::SetCwd( workingDir );
+	}
+
+	for ( std::map< wxString, PObjectInfo >::iterator it = m_objs.begin(); it != m_objs.end(); ++it )
+	{
+		it->second->SetComponentLibrary( NULL );
+	}
+}
+
 void ObjectDatabase::ImportComponentLibrary( wxString libfile, PwxFBManager manager )
 {
 	wxString path = libfile;
@@ -1565,7 +2089,7 @@ bool ObjectDatabase::LoadObjectTypes()
 			elem = elem->NextSiblingElement( "objtype", false );
 		}
 
-		// now load the children
+		// now load the children, in a type x type table so looking them up is immediate
 		elem = root->FirstChildElement("objtype");
 		while (elem)
 		{
@@ -1573,6 +2097,7 @@ bool ObjectDatabase::LoadObjectTypes()
 
 			// get the objType
 			PObjectType objType = GetObjectType( name );
+			objType->SetTypeCount( m_types.size() );
 			ticpp::Element* child = elem->FirstChildElement( "childtype", false );
 			while ( child )
 			{
@@ -1587,6 +2112,7 @@ bool ObjectDatabase::LoadObjectTypes()
 				if ( !childType )
 				{
 					wxLogError( _("No Object Type found for \"%s\""), childname.c_str() );
+					child = child->NextSiblingElement( "childtype", false );
 					continue;
 				}
 
@@ -149,8 +149,39 @@ class ObjectDatabase
   // used so libraries are only imported once, even if multiple libraries use them
   std::set< wxString > m_importedLibraries;
 
+  // libraries found by SetupPackage, imported when a component is first needed
+  // first = full path of the library, second = directory used as working directory
+  std::vector< std::pair< wxString, wxString > > m_pendingLibraries;
+  PwxFBManager m_manager;
+
   PTLangTemplateMap m_propertyTypeTemplates;
 
+  bool m_loadIcons;
+  bool m_concurrentLoad;
+  wxString m_iconCachePath;
+
+  // Icons of the classes found by LoadPackage, waiting for LoadIcons
+  struct IconRequest
+  {
+    PObjectInfo info;
+    wxString icon;       // empty if the class has no icon
+    wxString smallIcon;  // empty if the class has no small icon
+  };
+  std::vector< IconRequest > m_iconRequests;
+
+ public:
+  // How the last call to LoadIcons went, to compare cold and warm startups
+  struct IconStats
+  {
+    unsigned int icons;       // icon files and sizes decoded
+    unsigned int fromCache;   // read from the icon cache instead
+    unsigned int threads;
+    long milliseconds;
+  };
+
+ private:
+  IconStats m_iconStats;
+
   /**
    * Initialize the property type map.
    */
@@ -183,6 +214,12 @@ class ObjectDatabase
    */
   void SetupPackage( const wxString& file, const wxString& path, PwxFBManager manager );
 
+  /**
+   * Assigns a dense index to every class and precomputes the set of base
+   * classes of each one, so ObjectInfo::IsSubclassOf is a bit test.
+   */
+  void BuildClassHierarchy();
+
   /**
    * Determina si el tipo de objeto hay que incluirlo en la paleta de
    * componentes.
@@ -200,6 +237,13 @@ class ObjectDatabase
 
   void SetDefaultLayoutProperties(PObjectBase obj);
 
+  /**
+   * Creates the forms of a project being loaded on several threads.
+   * Returns false, having created nothing, if the children of @a parent
+   * must be created one after the other.
+   */
+  bool CreateChildrenConcurrently( PObjectBase parent, ticpp::Element* xml_parent );
+
  public:
   ObjectDatabase();
   ~ObjectDatabase();
@@ -222,6 +266,23 @@ class ObjectDatabase
   void SetIconPath( const wxString& path)  { m_iconPath = path; }
   void SetPluginPath( const wxString& path ) { m_pluginPath = path; }
 
+  /**
+   * The icons are only needed by the palette and the object tree, they are
+   * not loaded when generating code without GUI.
+   */
+  void SetLoadIcons( bool load ) { m_loadIcons = load; }
+
+  /**
+   * Directory where the scaled icons are kept between sessions.
+   */
+  void SetIconCachePath( const wxString& path ) { m_iconCachePath = path; }
+
+  /**
+   * The forms of a project are created concurrently when it is loaded, the
+   * result is the same as creating them one after the other.
+   */
+  void SetConcurrentLoad( bool concurrent ) { m_concurrentLoad = concurrent; }
+
   /**
    * Obtiene la ruta donde se encuentran los ficheros con la descripción de
    * objetos.
@@ -236,10 +297,27 @@ class ObjectDatabase
   bool LoadObjectTypes();
 
   /**
-   * Find and load plugins from the plugins directory
+   * Find and load plugins from the plugins directory.
+   * Only the package descriptions and code templates are read here, the
+   * component libraries are imported by ImportComponentLibraries.
    */
   void LoadPlugins( PwxFBManager manager );
 
+  /**
+   * Decode the icons of the classes loaded by LoadPlugins. The files are
+   * decoded and scaled by a pool of threads, or read from the icon cache.
+   */
+  void LoadIcons();
+
+  IconStats GetIconStats() const { return m_iconStats; }
+
+  /**
+   * Import the component libraries of the loaded plugins, if not done yet.
+   * Called by ObjectInfo::GetComponent, so that generating code from the
+   * templates never loads the plugins.
+   */
+  void ImportComponentLibraries();
+
   /**
    * Fabrica de objetos.
    * A partir del nombre de la clase se crea una nueva instancia de un objeto.
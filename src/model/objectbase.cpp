@@ -28,7 +28,9 @@
 #include "utils/debug.h"
 #include "utils/typeconv.h"
 #include "utils/stringutils.h"
+#include "utils/stringpool.h"
 #include "rad/appdata.h"
+#include "model/database.h"
 #include <ticpp.h>
 #include <wx/tokenzr.h>
 
@@ -57,7 +59,7 @@ EventInfo::EventInfo(const wxString &name, const wxString &eventClass,
 
 bool Property::IsDefaultValue()
 {
-	return (m_info->GetDefaultValue() == m_value);
+	return (m_info->GetDefaultValue() == *m_value);
 }
 
 bool Property::IsNull()
@@ -67,88 +69,115 @@ bool Property::IsNull()
 		case PT_BITMAP:
 		{
 			wxString path;
-			size_t semicolonIndex = m_value.find_first_of( wxT(";") );
-			if ( semicolonIndex != m_value.npos )
+			size_t semicolonIndex = m_value->find_first_of( wxT(";") );
+			if ( semicolonIndex != m_value->npos )
 			{
-				path = m_value.substr( 0, semicolonIndex );
+				path = m_value->substr( 0, semicolonIndex );
 			}
 			else
 			{
-				path = m_value;
+				path = *m_value;
 			}
 
 			return path.empty();
 		}
 		case PT_WXSIZE:
 		{
-			return ( wxDefaultSize == TypeConv::StringToSize( m_value ) );
+			return ( wxDefaultSize == TypeConv::StringToSize( *m_value ) );
 		}
 		default:
 		{
-			return m_value.empty();
+			return m_value->empty();
 		}
 	}
 }
 
+void Property::Assign( const StringPool::PString& value )
+{
+	// Equal values are pooled once, so the pointers tell whether it changed
+	if ( m_value == value )
+	{
+		return;
+	}
+
+	m_value = value;
+
+	PObjectBase object = m_object.lock();
+	if ( object )
+	{
+		object->InvalidateSnapshot();
+	}
+}
+
+void Property::SetValue( wxString& val )
+{
+	Assign( StringPool::Intern( val ) );
+}
+
+void Property::SetValue( const wxChar* val )
+{
+	Assign( StringPool::Intern( val ) );
+}
+
 void Property::SetDefaultValue()
 {
-	m_value = m_info->GetDefaultValue();
+	Assign( StringPool::Intern( m_info->GetDefaultValue() ) );
 }
 
 void Property::SetValue(const wxFontContainer &font)
 {
-	m_value = TypeConv::FontToString( font );
+	Assign( StringPool::Intern( TypeConv::FontToString( font ) ) );
 }
 void Property::SetValue(const wxColour &colour)
 {
-	m_value = TypeConv::ColourToString( colour );
+	Assign( StringPool::Intern( TypeConv::ColourToString( colour ) ) );
 }
 void Property::SetValue(const wxString &str, bool format)
 {
-	m_value = (format ? TypeConv::TextToString(str) : str );
+	Assign( StringPool::Intern( format ? TypeConv::TextToString(str) : str ) );
 }
 
 void Property::SetValue(const wxPoint &point)
 {
-	m_value = TypeConv::PointToString(point);
+	Assign( StringPool::Intern( TypeConv::PointToString(point) ) );
 }
 
 void Property::SetValue(const wxSize &size)
 {
-	m_value = TypeConv::SizeToString(size);
+	Assign( StringPool::Intern( TypeConv::SizeToString(size) ) );
 }
 
 void Property::SetValue(const int integer)
 {
-	m_value = StringUtils::IntToStr(integer);
+	Assign( StringPool::Intern( StringUtils::IntToStr(integer) ) );
 }
 
 void Property::SetValue(const double val )
 {
-	m_value = TypeConv::FloatToString( val );
+	Assign( StringPool::Intern( TypeConv::FloatToString( val ) ) );
 }
 
 wxFontContainer Property::GetValueAsFont()
 {
-	return TypeConv::StringToFont( m_value );
+	return TypeConv::StringToFont( *m_value );
 }
 
 wxColour Property::GetValueAsColour()
 {
-	return TypeConv::StringToColour(m_value);
+	return TypeConv::StringToColour(*m_value);
 }
 wxPoint Property::GetValueAsPoint()
 {
-	return TypeConv::StringToPoint(m_value);
+	return TypeConv::StringToPoint(*m_value);
 }
 wxSize Property::GetValueAsSize()
 {
-	return TypeConv::StringToSize(m_value);
+	return TypeConv::StringToSize(*m_value);
 }
 
 wxBitmap Property::GetValueAsBitmap()
 {
-	return TypeConv::StringToBitmap( m_value );
+	return TypeConv::StringToBitmap( *m_value );
 }
 
 int Property::GetValueAsInteger()
@@ -160,13 +189,13 @@ int Property::GetValueAsInteger()
 	case PT_EDIT_OPTION:
 	case PT_OPTION:
 	case PT_MACRO:
-		result = TypeConv::GetMacroValue(m_value);
+		result = TypeConv::GetMacroValue(*m_value);
 		break;
 	case PT_BITLIST:
-		result = TypeConv::BitlistToInt(m_value);
+		result = TypeConv::BitlistToInt(*m_value);
 		break;
 	default:
-		result = TypeConv::StringToInt(m_value);
+		result = TypeConv::StringToInt(*m_value);
 		break;
 	}
 	return result;
@@ -174,22 +203,22 @@ int Property::GetValueAsInteger()
 
 wxString Property::GetValueAsString()
 {
-	return m_value;
+	return *m_value;
 }
 
 wxString Property::GetValueAsText()
 {
-	return TypeConv::StringToText(m_value);
+	return TypeConv::StringToText(*m_value);
 }
 
 wxArrayString Property::GetValueAsArrayString()
 {
-	return TypeConv::StringToArrayString(m_value);
+	return TypeConv::StringToArrayString(*m_value);
 }
 
 double Property::GetValueAsFloat()
 {
-	return TypeConv::StringToFloat(m_value);
+	return TypeConv::StringToFloat(*m_value);
 }
 
 void Property::SplitParentProperty( std::map< wxString, wxString >* children )
@@ -203,7 +232,7 @@ void Property::SplitParentProperty( std::map< wxString, wxString >* children )
 	std::list< PropertyChild >* myChildren = m_info->GetChildren();
 	std::list< PropertyChild >::iterator it = myChildren->begin();
 
-	wxStringTokenizer tkz( m_value, wxT(";"), wxTOKEN_RET_EMPTY_ALL );
+	wxStringTokenizer tkz( *m_value, wxT(";"), wxTOKEN_RET_EMPTY_ALL );
 	while ( tkz.HasMoreTokens() )
 	{
 		if ( myChildren->end() == it )
@@ -236,6 +265,18 @@ wxString Property::GetChildFromParent( const wxString& childName )
 	}
 }
 
+void Event::SetValue(const wxString &value)
+{
+  if ( m_value == value )
+    return;
+
+  m_value = value;
+
+  PObjectBase object = m_object.lock();
+  if ( object )
+    object->InvalidateSnapshot();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 const int ObjectBase::INDENT = 2;
 
@@ -262,6 +303,20 @@ ObjectBase::~ObjectBase()
 	LogDebug(wxT("delete ObjectBase"));
 }
 
+void ObjectBase::InvalidateSnapshot()
+{
+	// The snapshot of an object holds the snapshots of its children, so the
+	// ancestors of an object without snapshot have none either
+	ObjectBase* obj = this;
+	PObjectBase parent;
+	while ( obj && !obj->m_snapshot.expired() )
+	{
+		obj->m_snapshot.reset();
+		parent = obj->m_parent.lock();
+		obj = parent.get();
+	}
+}
+
 wxString ObjectBase::GetIndentString(int indent)
 {
 	int i;
@@ -338,7 +393,10 @@ PEvent ObjectBase::GetEvent (unsigned int idx)
 
 void ObjectBase::AddProperty (PProperty prop)
 {
-	m_properties.insert( PropertyMap::value_type( prop->GetName(), prop ) );
+	if ( m_properties.insert( PropertyMap::value_type( prop->GetName(), prop ) ).second )
+	{
+		m_propertyList.push_back( prop );
+	}
 }
 
 void ObjectBase::AddEvent(PEvent event)
@@ -393,6 +451,7 @@ bool ObjectBase::AddChild (PObjectBase obj)
 		//if (ChildTypeOk(obj->GetObjectTypeName()))
 	{
 		m_children.push_back(obj);
+		InvalidateSnapshot();
 		result = true;
 	}
 
@@ -406,6 +465,7 @@ bool ObjectBase::AddChild (unsigned int idx, PObjectBase obj)
 		//if (ChildTypeOk(obj->GetObjectTypeName()) && idx <= m_children.size())
 	{
 		m_children.insert(m_children.begin() + idx,obj);
+		InvalidateSnapshot();
 		result = true;
 	}
 
@@ -465,7 +525,10 @@ void ObjectBase::RemoveChild (PObjectBase obj)
 		it++;
 
 	if (it != m_children.end())
+	{
 		m_children.erase(it);
+		InvalidateSnapshot();
+	}
 }
 
 void ObjectBase::RemoveChild (unsigned int idx)
@@ -474,6 +537,7 @@ void ObjectBase::RemoveChild (unsigned int idx)
 
 	std::vector< PObjectBase >::iterator it =  m_children.begin() + idx;
 	m_children.erase(it);
+	InvalidateSnapshot();
 }
 
 PObjectBase ObjectBase::GetChild (unsigned int idx)
@@ -744,6 +808,172 @@ wxString ObjectBase::GetChildFromParentProperty( const wxString& parentName, con
 		return wxEmptyString;
 }
 
+PropertyHandle ObjectBase::GetPropertyHandle( const wxString& pname )
+{
+	PProperty property = GetProperty( pname );
+	if ( !property )
+		return PropertyHandle();
+
+	for ( size_t i = 0; i < m_propertyList.size(); ++i )
+	{
+		if ( m_propertyList[i] == property )
+			return PropertyHandle( (int)i );
+	}
+
+	return PropertyHandle();
+}
+
+PProperty ObjectBase::GetProperty( const PropertyHandle& handle )
+{
+	if ( !handle.IsOk() || (size_t)handle.GetIndex() >= m_propertyList.size() )
+		return PProperty();
+
+	return m_propertyList[ handle.GetIndex() ];
+}
+
+bool ObjectBase::IsNull (const PropertyHandle& handle)
+{
+	PProperty property = GetProperty( handle );
+	if (property)
+		return property->IsNull();
+	else
+		return true;
+}
+
+int ObjectBase::GetPropertyAsInteger (const PropertyHandle& handle)
+{
+	PProperty property = GetProperty( handle );
+	if (property)
+		return property->GetValueAsInteger();
+	else
+		return 0;
+}
+
+bool ObjectBase::GetPropertyAsBoolean(const PropertyHandle& handle)
+{
+	return GetPropertyAsInteger(handle) != 0;
+}
+
+wxFontContainer ObjectBase::GetPropertyAsFont(const PropertyHandle& handle)
+{
+	PProperty property = GetProperty( handle );
+	if (property)
+		return property->GetValueAsFont();
+	else
+		return wxFontContainer();
+}
+
+wxColour ObjectBase::GetPropertyAsColour(const PropertyHandle& handle)
+{
+	PProperty property = GetProperty( handle );
+	if (property)
+		return property->GetValueAsColour();
+	else
+		return wxColour();
+}
+
+wxString ObjectBase::GetPropertyAsString(const PropertyHandle& handle)
+{
+	PProperty property = GetProperty( handle );
+	if (property)
+		return property->GetValueAsString();
+	else
+		return wxString();
+}
+
+wxPoint ObjectBase::GetPropertyAsPoint(const PropertyHandle& handle)
+{
+	PProperty property = GetProperty( handle );
+	if (property)
+		return property->GetValueAsPoint();
+	else
+		return wxPoint();
+}
+
+wxSize ObjectBase::GetPropertyAsSize(const PropertyHandle& handle)
+{
+	PProperty property = GetProperty( handle );
+	if (property)
+		return property->GetValueAsSize();
+	else
+		return wxDefaultSize;
+}
+
+wxBitmap ObjectBase::GetPropertyAsBitmap(const PropertyHandle& handle)
+{
+	PProperty property = GetProperty( handle );
+	if (property)
+		return property->GetValueAsBitmap();
+	else
+		return wxBitmap();
+}
+
+double ObjectBase::GetPropertyAsFloat(const PropertyHandle& handle)
+{
+	PProperty property = GetProperty( handle );
+	if (property)
+		return property->GetValueAsFloat();
+	else
+		return 0;
+}
+
+wxArrayInt ObjectBase::GetPropertyAsArrayInt(const PropertyHandle& handle)
+{
+	wxArrayInt array;
+	PProperty property = GetProperty( handle );
+	if (property)
+	{
+		IntList il( property->GetValue(), property->GetType() == PT_UINTLIST );
+		for (unsigned int i=0; i < il.GetSize() ; i++)
+			array.Add(il.GetValue(i));
+	}
+
+	return array;
+}
+
+wxArrayString ObjectBase::GetPropertyAsArrayString(const PropertyHandle& handle)
+{
+	PProperty property = GetProperty( handle );
+	if (property)
+		return property->GetValueAsArrayString();
+	else
+		return wxArrayString();
+}
+
+void ObjectBase::GetPropertyValues( const PropertyHandle* handles, unsigned int count, PropertyValue* values )
+{
+	for ( unsigned int i = 0; i < count; ++i )
+	{
+		PropertyValue& value = values[i];
+		value = PropertyValue();
+
+		PProperty property = GetProperty( handles[i] );
+		if ( !property )
+			continue;
+
+		value.isNull = property->IsNull();
+		value.text = property->GetValue();
+
+		switch ( property->GetType() )
+		{
+		case PT_BOOL:
+		case PT_INT:
+		case PT_UINT:
+		case PT_BITLIST:
+		case PT_OPTION:
+		case PT_EDIT_OPTION:
+		case PT_MACRO:
+			value.integer = property->GetValueAsInteger();
+			break;
+		case PT_FLOAT:
+			value.number = property->GetValueAsFloat();
+			break;
+		default:
+			break;
+		}
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 ObjectInfo::ObjectInfo(wxString class_name, PObjectType type, WPObjectPackage package, bool startGroup )
@@ -752,9 +982,11 @@ ObjectInfo::ObjectInfo(wxString class_name, PObjectType type, WPObjectPackage pa
 	m_type = type;
 	m_numIns = 0;
 	m_component = NULL;
+	m_database = NULL;
 	m_package = package;
 	m_category = PPropertyCategory( new PropertyCategory( m_class ) );
 	m_startGroup = startGroup;
+	m_classIndex = -1;
 }
 
 PObjectPackage ObjectInfo::GetPackage()
@@ -762,6 +994,18 @@ PObjectPackage ObjectInfo::GetPackage()
 	return m_package.lock();
 }
 
+IComponent* ObjectInfo::GetComponent()
+{
+	if ( NULL == m_component && m_database )
+	{
+		ObjectDatabase* database = m_database;
+		m_database = NULL;
+		database->ImportComponentLibraries();
+	}
+
+	return m_component;
+}
+
 PPropertyInfo ObjectInfo::GetPropertyInfo(wxString name)
 {
 	PPropertyInfo result;
@@ -867,6 +1111,12 @@ PObjectInfo ObjectInfo::GetBaseClass(unsigned int idx, bool inherited)
 {
 	if( inherited )
 	{
+		if ( m_classIndex >= 0 )
+		{
+			assert (idx < m_allBases.size());
+			return m_allBases[idx];
+		}
+
 		std::vector<PObjectInfo> classes;
 		GetBaseClasses( classes );
 
@@ -884,6 +1134,11 @@ unsigned int ObjectInfo::GetBaseClassCount(bool inherited)
 {
 	if( inherited )
 	{
+		if ( m_classIndex >= 0 )
+		{
+			return (unsigned int)m_allBases.size();
+		}
+
 		std::vector<PObjectInfo> classes;
 		GetBaseClasses( classes );
 
@@ -895,6 +1150,12 @@ unsigned int ObjectInfo::GetBaseClassCount(bool inherited)
 
 void ObjectInfo::GetBaseClasses(std::vector<PObjectInfo> &classes, bool inherited)
 {
+	if ( inherited && m_classIndex >= 0 )
+	{
+		classes.insert( classes.end(), m_allBases.begin(), m_allBases.end() );
+		return;
+	}
+
 	for ( std::vector<PObjectInfo>::iterator it = m_base.begin(); it != m_base.end(); ++it )
 	{
 		PObjectInfo base_info = *it;;
@@ -904,8 +1165,38 @@ void ObjectInfo::GetBaseClasses(std::vector<PObjectInfo> &classes, bool inherite
 	}
 }
 
+void ObjectInfo::SetClassHierarchy( int index, const std::vector< bool >& ancestors, const std::vector< PObjectInfo >& bases, std::shared_ptr< const ClassIndexMap > classIndex )
+{
+	m_classIndex = index;
+	m_ancestors = ancestors;
+	m_allBases = bases;
+	m_classIndexMap = classIndex;
+}
+
+bool ObjectInfo::IsSubclassOf(PObjectInfo base)
+{
+	if ( !base )
+	{
+		return false;
+	}
+
+	if ( m_classIndex >= 0 && base->m_classIndex >= 0 )
+	{
+		return IsSubclassOf( base->m_classIndex );
+	}
+
+	return IsSubclassOf( base->GetClassName() );
+}
+
 bool ObjectInfo::IsSubclassOf(wxString classname)
 {
+	// With the hierarchy built, it is a bit test
+	if ( m_classIndexMap )
+	{
+		ClassIndexMap::const_iterator index = m_classIndexMap->find( classname );
+		return ( index != m_classIndexMap->end() && IsSubclassOf( index->second ) );
+	}
+
 	bool found = false;
 
 	if (GetClassName() == classname)
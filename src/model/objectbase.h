@@ -35,6 +35,7 @@
 
 #include <iostream>
 #include <wx/string.h>
+#include <wx/hashmap.h>
 #include <list>
 
 #include "types.h"
@@ -44,6 +45,9 @@
 #include <component.h>
 
 #include "utils/wxfbdefs.h"
+#include "utils/stringpool.h"
+
+class ObjectDatabase;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -139,14 +143,20 @@ public:
 
 class Property
 {
+	friend class ObjectSnapshot;
 private:
 	PPropertyInfo m_info;   // pointer to its descriptor
 	WPObjectBase  m_object; // pointer to the owner object
 
-	wxString m_value;
+	StringPool::PString m_value; // shared with the properties holding the same value
+
+	// Stores a new value, the owner is told it changed
+	void Assign( const StringPool::PString& value );
 
 public:
 	Property(PPropertyInfo info, PObjectBase obj = PObjectBase())
+	:
+	m_value( StringPool::Empty() )
 	{
 		m_object = obj;
 		m_info = info;
@@ -154,9 +164,9 @@ public:
 
 	PObjectBase GetObject() { return m_object.lock(); }
 	wxString GetName()                 { return m_info->GetName(); }
-	wxString GetValue()                { return m_value; }
-	void SetValue( wxString& val )     { m_value = val; }
-	void SetValue( const wxChar* val )       { m_value = val;	}
+	wxString GetValue()                { return *m_value; }
+	void SetValue( wxString& val );
+	void SetValue( const wxChar* val );
 
 	PPropertyInfo GetPropertyInfo() { return m_info; }
 	PropertyType  GetType()         { return m_info->GetType();  }
@@ -195,6 +205,7 @@ public:
 
 class Event
 {
+  friend class ObjectSnapshot;
 private:
   PEventInfo  m_info;   // pointer to its descriptor
   WPObjectBase m_object; // pointer to the owner object
@@ -205,7 +216,7 @@ public:
     : m_info(info), m_object(obj)
   {}
 
-  void SetValue(const wxString &value) { m_value = value; }
+  void SetValue(const wxString &value);
   wxString GetValue()                  { return m_value; }
   wxString GetName()                   { return m_info->GetName(); }
   PObjectBase GetObject()              { return m_object.lock(); }
@@ -278,6 +289,8 @@ namespace ticpp
 class ObjectBase : public IObject, public std::enable_shared_from_this<ObjectBase>
 {
 	friend class wxFBDataObject;
+	friend class ProjectAnalysis;
+	friend class ObjectSnapshot;
 private:
 	wxString     m_class;  // class name
 	wxString     m_type;   // type of object
@@ -285,9 +298,11 @@ private:
 
 	ObjectBaseVector m_children;
 	PropertyMap      m_properties;
+	std::vector< PProperty > m_propertyList; // in insertion order, indexed by PropertyHandle
 	EventMap         m_events;
 	PObjectInfo      m_info;
 	bool m_expanded; // is expanded in the object tree, allows for saving to file
+	WPObjectSnapshot m_snapshot; // last snapshot taken or restored, dropped when the object changes
 
 protected:
 	// utilites for implementing the tree
@@ -314,7 +329,14 @@ public:
 	/**
 	Sets whether the object is expanded in the object tree or not.
 	*/
-	void SetExpanded( bool expanded ){ m_expanded = expanded; }
+	void SetExpanded( bool expanded )
+	{
+		if ( m_expanded != expanded )
+		{
+			m_expanded = expanded;
+			InvalidateSnapshot();
+		}
+	}
 
 	/**
 	Gets whether the object is expanded in the object tree or not.
@@ -336,6 +358,12 @@ public:
 	/// Links the object to a parent
 	void SetParent(PObjectBase parent)  { m_parent = parent; }
 
+	/**
+	* Drops the last snapshot of the object and of its ancestors, which no
+	* longer describe them. Called by every change of the object.
+	*/
+	void InvalidateSnapshot();
+
 	/**
 	* Obtiene la propiedad identificada por el nombre.
 	*
@@ -533,6 +561,26 @@ public:
 	wxString GetChildFromParentProperty( const wxString& parentName, const wxString& childName );
 	
 	IObject* GetChildPtr (unsigned int idx) { return GetChild(idx).get(); }
+
+	// Acceso mediante handles, resueltos una vez por clase
+	PropertyHandle GetPropertyHandle( const wxString& pname );
+	PProperty GetProperty( const PropertyHandle& handle );
+
+	bool     IsNull (const PropertyHandle& handle);
+	int      GetPropertyAsInteger (const PropertyHandle& handle);
+	bool	 GetPropertyAsBoolean(const PropertyHandle& handle);
+	wxFontContainer   GetPropertyAsFont    (const PropertyHandle& handle);
+	wxColour GetPropertyAsColour  (const PropertyHandle& handle);
+	wxString GetPropertyAsString  (const PropertyHandle& handle);
+	wxPoint  GetPropertyAsPoint   (const PropertyHandle& handle);
+	wxSize   GetPropertyAsSize    (const PropertyHandle& handle);
+	wxBitmap GetPropertyAsBitmap  (const PropertyHandle& handle);
+	double	 GetPropertyAsFloat	  (const PropertyHandle& handle);
+
+	wxArrayInt    GetPropertyAsArrayInt (const PropertyHandle& handle);
+	wxArrayString GetPropertyAsArrayString  (const PropertyHandle& handle);
+
+	void GetPropertyValues( const PropertyHandle* handles, unsigned int count, PropertyValue* values );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -553,6 +601,9 @@ public:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/** Dense index of every class, assigned by ObjectDatabase::BuildClassHierarchy */
+WX_DECLARE_STRING_HASH_MAP( int, ClassIndexMap );
+
 /**
 * Información de objeto o MetaObjeto.
 */
@@ -631,6 +682,7 @@ public:
 	// nos serán utiles para generar el nombre del objeto
 	unsigned int GetInstanceCount() { return m_numIns; }
 	void IncrementInstanceCount()   { m_numIns++; }
+	void AddInstanceCount( unsigned int count ) { m_numIns += count; }
 	void ResetInstanceCount() { m_numIns = 0; }
 
 	/**
@@ -647,6 +699,29 @@ public:
 	*/
 	bool IsSubclassOf(wxString classname);
 
+	/**
+	* Constant time check using the index of a class, see GetClassIndex.
+	*/
+	bool IsSubclassOf(int classIndex)
+	{
+		return ( classIndex >= 0 && (size_t)classIndex < m_ancestors.size() && m_ancestors[classIndex] );
+	}
+
+	bool IsSubclassOf(PObjectInfo base);
+
+	/**
+	* Index of the class in the database, -1 until the hierarchy is built.
+	*/
+	int GetClassIndex() { return m_classIndex; }
+
+	/**
+	* Stores the precomputed hierarchy.
+	* @param ancestors Bit set by the index of this class and of every base class.
+	* @param bases Every base class, as listed by GetBaseClasses.
+	* @param classIndex Index of every class of the database, by name.
+	*/
+	void SetClassHierarchy( int index, const std::vector< bool >& ancestors, const std::vector< PObjectInfo >& bases, std::shared_ptr< const ClassIndexMap > classIndex );
+
 	PObjectInfo GetBaseClass(unsigned int idx, bool inherited = true);
 	void GetBaseClasses(std::vector<PObjectInfo> &classes, bool inherited = true);
 	unsigned int GetBaseClassCount(bool inherited = true);
@@ -668,7 +743,23 @@ public:
 	* Le asigna un componente a la clase.
 	*/
 	void SetComponent(IComponent *c) { m_component = c; };
-	IComponent* GetComponent() { return m_component; };
+
+	/**
+	* Obtiene el componente de la clase. The component libraries are imported
+	* on the first call that needs one of them.
+	*/
+	IComponent* GetComponent();
+
+	/**
+	* Records the database that will import the library providing the component.
+	*/
+	void SetComponentLibrary( ObjectDatabase* database ) { m_database = database; }
+
+	/**
+	* True if the class has a component, or a library that should provide it
+	* has not been imported yet.
+	*/
+	bool HasComponent() { return ( m_component != NULL || m_database != NULL ); }
 
 private:
 	wxString m_class;         // nombre de la clase (tipo de objeto)
@@ -690,9 +781,14 @@ private:
 	std::map< wxString, PEventInfo >    m_events;
 
 	std::vector< PObjectInfo > m_base; // base classes
+	int m_classIndex;                  // index in the database, -1 if not assigned
+	std::vector< bool > m_ancestors;   // indexes of the class and all of its bases
+	std::vector< PObjectInfo > m_allBases; // inherited base classes, once the hierarchy is built
+	std::shared_ptr< const ClassIndexMap > m_classIndexMap;
 	std::map< size_t, std::map< wxString, wxString > > m_baseClassDefaultPropertyValues;
 	IComponent* m_component;  // componente asociado a la clase los objetos del
 	// designer
+	ObjectDatabase* m_database; // imports the component library on demand, NULL once imported
 };
 
 #endif
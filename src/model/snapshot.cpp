@@ -0,0 +1,171 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "snapshot.h"
+#include "objectbase.h"
+
+#include <set>
+
+ObjectSnapshot::ObjectSnapshot( PObjectBase object )
+:
+m_object( object ),
+m_expanded( object->m_expanded )
+{
+}
+
+PObjectSnapshot ObjectSnapshot::Take( PObjectBase object, size_t* memoryUsage )
+{
+	PObjectSnapshot snapshot = object->m_snapshot.lock();
+	if ( snapshot )
+	{
+		return snapshot;
+	}
+
+	ObjectSnapshot* node = new ObjectSnapshot( object );
+	snapshot = PObjectSnapshot( node );
+
+	std::vector< PProperty >& properties = object->m_propertyList;
+	node->m_properties.reserve( properties.size() );
+	for ( std::vector< PProperty >::iterator property = properties.begin(); property != properties.end(); ++property )
+	{
+		node->m_properties.push_back( ( *property )->m_value );
+	}
+
+	node->m_events.reserve( object->m_events.size() );
+	for ( EventMap::iterator event = object->m_events.begin(); event != object->m_events.end(); ++event )
+	{
+		node->m_events.push_back( event->second->m_value );
+	}
+
+	node->m_children.reserve( object->m_children.size() );
+	for ( ObjectBaseVector::iterator child = object->m_children.begin(); child != object->m_children.end(); ++child )
+	{
+		node->m_children.push_back( Take( *child, memoryUsage ) );
+	}
+
+	object->m_snapshot = snapshot;
+
+	if ( memoryUsage )
+	{
+		*memoryUsage += node->GetMemoryUsage();
+	}
+
+	return snapshot;
+}
+
+void ObjectSnapshot::Restore( PObjectSnapshot snapshot, std::vector< PObjectBase >* restored )
+{
+	PObjectBase object = snapshot->m_object;
+
+	// Unchanged since this snapshot was taken or restored, and so is the subtree
+	if ( object->m_snapshot.lock() == snapshot )
+	{
+		return;
+	}
+
+	std::vector< PProperty >& properties = object->m_propertyList;
+	for ( size_t i = 0; i < properties.size() && i < snapshot->m_properties.size(); ++i )
+	{
+		properties[i]->m_value = snapshot->m_properties[i];
+	}
+
+	size_t index = 0;
+	for ( EventMap::iterator event = object->m_events.begin(); event != object->m_events.end() && index < snapshot->m_events.size(); ++event, ++index )
+	{
+		event->second->m_value = snapshot->m_events[ index ];
+	}
+
+	object->m_expanded = snapshot->m_expanded;
+
+	ObjectBaseVector children;
+	children.reserve( snapshot->m_children.size() );
+	for ( std::vector< PObjectSnapshot >::const_iterator child = snapshot->m_children.begin(); child != snapshot->m_children.end(); ++child )
+	{
+		children.push_back( ( *child )->m_object );
+	}
+
+	if ( children != object->m_children )
+	{
+		// Unlink the children left out, unless an object restored before has
+		// already taken them
+		std::set< ObjectBase* > kept;
+		for ( ObjectBaseVector::iterator child = children.begin(); child != children.end(); ++child )
+		{
+			kept.insert( child->get() );
+		}
+
+		for ( ObjectBaseVector::iterator child = object->m_children.begin(); child != object->m_children.end(); ++child )
+		{
+			if ( kept.find( child->get() ) == kept.end() && ( *child )->GetParent() == object )
+			{
+				( *child )->SetParent( PObjectBase() );
+			}
+		}
+
+		object->m_children.swap( children );
+
+		for ( ObjectBaseVector::iterator child = object->m_children.begin(); child != object->m_children.end(); ++child )
+		{
+			PObjectBase parent = ( *child )->GetParent();
+			if ( parent != object )
+			{
+				// The former parent still lists the child, so it no longer
+				// matches its snapshot
+				if ( parent )
+				{
+					parent->InvalidateSnapshot();
+				}
+				( *child )->SetParent( object );
+			}
+		}
+	}
+
+	for ( std::vector< PObjectSnapshot >::const_iterator child = snapshot->m_children.begin(); child != snapshot->m_children.end(); ++child )
+	{
+		Restore( *child, restored );
+	}
+
+	object->m_snapshot = snapshot;
+
+	if ( restored )
+	{
+		restored->push_back( object );
+	}
+}
+
+size_t ObjectSnapshot::GetMemoryUsage() const
+{
+	size_t size = sizeof( ObjectSnapshot );
+	size += m_properties.size() * sizeof( StringPool::PString );
+	size += m_children.size() * sizeof( PObjectSnapshot );
+
+	for ( std::vector< wxString >::const_iterator event = m_events.begin(); event != m_events.end(); ++event )
+	{
+		size += sizeof( wxString ) + event->length() * sizeof( wxChar );
+	}
+
+	return size;
+}
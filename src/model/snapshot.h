@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef __OBJECT_SNAPSHOT__
+#define __OBJECT_SNAPSHOT__
+
+#include "utils/wxfbdefs.h"
+#include "utils/stringpool.h"
+#include <wx/string.h>
+#include <vector>
+
+/**
+ * Immutable state of an object and of its subtree: the values of its
+ * properties and events, whether it is expanded and its children.
+ *
+ * Snapshots taken at different moments share the nodes of the objects that did
+ * not change in between. Each object remembers its last snapshot until it
+ * changes, so taking a snapshot builds only the nodes of the objects changed
+ * since the previous one, and restoring a snapshot only visits the objects
+ * that differ from it.
+ */
+class ObjectSnapshot
+{
+private:
+	PObjectBase m_object;
+	std::vector< StringPool::PString > m_properties; // in the order they were added to the object
+	std::vector< wxString > m_events;                // in the order of the event map
+	std::vector< PObjectSnapshot > m_children;
+	bool m_expanded;
+
+	ObjectSnapshot( PObjectBase object );
+
+public:
+	/**
+	 * Takes the snapshot of an object and its subtree.
+	 * @param memoryUsage if not NULL, the size of the new nodes is added to it.
+	 */
+	static PObjectSnapshot Take( PObjectBase object, size_t* memoryUsage = NULL );
+
+	/**
+	 * Brings the object of the snapshot and its subtree back to the state of
+	 * the snapshot. The same objects are relinked, so the references held by
+	 * the views stay valid.
+	 * @param restored if not NULL, receives the objects that were changed.
+	 */
+	static void Restore( PObjectSnapshot snapshot, std::vector< PObjectBase >* restored = NULL );
+
+	PObjectBase GetObject() const { return m_object; }
+
+	/**
+	 * Approximate number of bytes of this node, without the shared values and
+	 * the nodes of the children.
+	 */
+	size_t GetMemoryUsage() const;
+};
+
+#endif //__OBJECT_SNAPSHOT__
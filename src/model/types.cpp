@@ -43,24 +43,37 @@ void ObjectType::AddChildType(PObjectType type, int max, int aui_max)
 {
 	/*assert(max != 0);
 	assert(aui_max != 0);*/
-	m_childTypes.insert(ChildTypeMap::value_type(type,ChildCount(max, aui_max)));
+	if ( !m_childTypes.insert(ChildTypeMap::value_type(type,ChildCount(max, aui_max))).second )
+	{
+		// the first definition is kept
+		return;
+	}
+
+	size_t id = (size_t)type->GetId();
+	if ( id >= m_childTable.size() )
+	{
+		m_childTable.resize( id + 1, ChildCount(0, 0) );
+	}
+	m_childTable[id] = ChildCount(max, aui_max);
+}
+
+void ObjectType::SetTypeCount(size_t count)
+{
+	if ( count > m_childTable.size() )
+	{
+		m_childTable.resize( count, ChildCount(0, 0) );
+	}
 }
 
 int ObjectType::FindChildType(int type_id, bool aui)
 {
-	int max = 0;
-	ChildTypeMap::iterator it;
-	for (it = m_childTypes.begin(); it != m_childTypes.end() && max == 0; it++)
+	if ( type_id < 0 || (size_t)type_id >= m_childTable.size() )
 	{
-		PObjectType type(it->first);
-		if (type && type_id == type->GetId())
-		{
-			if( aui ) max = it->second.aui_max;
-			else
-				max = it->second.max;
-		}
+		return 0;
 	}
-	return max;
+
+	const ChildCount& count = m_childTable[type_id];
+	return ( aui ? count.aui_max : count.max );
 }
 
 int ObjectType::FindChildType(PObjectType type, bool aui)
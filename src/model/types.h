@@ -88,6 +88,12 @@ public:
 	 */
 	void AddChildType(PObjectType type, int max = -1, int aui_max = -1);
 
+	/**
+	 * Sizes the table of child counts for all the types of the database, so
+	 * FindChildType is an index in the table.
+	 */
+	void SetTypeCount(size_t count);
+
 	/**
 	 * Busca si el tipo pasado como parámetros está entre sus posibles
 	 * hijos.
@@ -126,6 +132,7 @@ private:
                      */
 
 	ChildTypeMap m_childTypes; /**< registro de posibles hijos */
+	std::vector< ChildCount > m_childTable; /**< row of the type x type matrix, by type id */
 };
 
 /**
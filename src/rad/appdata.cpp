@@ -34,12 +34,15 @@
 #include "utils/stringutils.h"
 #include "utils/wxfbipc.h"
 #include "utils/wxfbexception.h"
+#include "utils/trace.h"
 #include "codegen/cppcg.h"
 #include "codegen/pythoncg.h"
 #include "codegen/phpcg.h"
 #include "codegen/luacg.h"
 #include "codegen/xrccg.h"
 #include "codegen/codewriter.h"
+#include "codegen/projectcg.h"
+#include "codegen/codeanalysis.h"
 #include "rad/xrcpreview/xrcpreview.h"
 #include "rad/dataobject/dataobject.h"
 
@@ -56,6 +59,10 @@
 #include <wx/fs_mem.h>
 #include <wx/fs_arc.h>
 #include <wx/fs_filter.h>
+#include <wx/config.h>
+#include <wx/stopwatch.h>
+#include <wx/stdpaths.h>
+#include <wx/app.h>
 
 using namespace TypeConv;
 
@@ -75,10 +82,10 @@ class ExpandObjectCmd : public Command
 
 	protected:
 		void DoExecute();
-		void DoRestore();
 
 	public:
 		ExpandObjectCmd( PObjectBase object, bool expand );
+		wxString GetDescription();
 };
 
 /**
@@ -93,15 +100,13 @@ class InsertObjectCmd : public Command
 		PObjectBase m_parent;
 		PObjectBase m_object;
 		int m_pos;
-		PObjectBase m_oldSelected;
-
 
 	protected:
 		void DoExecute();
-		void DoRestore();
 
 	public:
 		InsertObjectCmd( ApplicationData *data, PObjectBase object, PObjectBase parent, int pos = -1 );
+		wxString GetDescription();
 };
 
 /**
@@ -116,14 +121,13 @@ class RemoveObjectCmd : public Command
 		PObjectBase m_parent;
 		PObjectBase m_object;
 		int m_oldPos;
-		PObjectBase m_oldSelected;
 
 	protected:
 		void DoExecute();
-		void DoRestore();
 
 	public:
 		RemoveObjectCmd( ApplicationData *data, PObjectBase object );
+		wxString GetDescription();
 };
 
 /**
@@ -134,15 +138,19 @@ class ModifyPropertyCmd : public Command
 {
 
 	private:
+		ApplicationData *m_data;
 		PProperty m_property;
-		wxString m_oldValue, m_newValue;
+		wxString m_value;
+
+		wxLongLong m_time;
 
 	protected:
 		void DoExecute();
-		void DoRestore();
 
 	public:
-		ModifyPropertyCmd( PProperty prop, wxString value );
+		ModifyPropertyCmd( ApplicationData *data, PProperty prop, wxString value );
+		bool Merge( Command* next );
+		wxString GetDescription();
 };
 
 /**
@@ -154,14 +162,14 @@ class ModifyEventHandlerCmd : public Command
 
 	private:
 		PEvent m_event;
-		wxString m_oldValue, m_newValue;
+		wxString m_value;
 
 	protected:
 		void DoExecute();
-		void DoRestore();
 
 	public:
 		ModifyEventHandlerCmd( PEvent event, wxString value );
+		wxString GetDescription();
 };
 
 /**
@@ -177,11 +185,10 @@ class ShiftChildCmd : public Command
 
 	protected:
 		void DoExecute();
-		void DoRestore();
 
 	public:
 		ShiftChildCmd( PObjectBase object, int pos );
-
+		wxString GetDescription();
 };
 
 /**
@@ -199,14 +206,13 @@ class CutObjectCmd : public Command
 		PObjectBase m_parent;
 		PObjectBase m_object;
 		int m_oldPos;
-		PObjectBase m_oldSelected;
 
 	protected:
 		void DoExecute();
-		void DoRestore();
 
 	public:
 		CutObjectCmd( ApplicationData *data, PObjectBase object );
+		wxString GetDescription();
 };
 
 /**
@@ -220,19 +226,50 @@ class ReparentObjectCmd : public Command
 		PObjectBase m_sizeritem;
 		PObjectBase m_sizer;
 		PObjectBase m_oldSizer;
-		int m_oldPosition;
 
 	protected:
 		void DoExecute();
-		void DoRestore();
 
 	public:
 		ReparentObjectCmd ( PObjectBase sizeritem, PObjectBase sizer );
+		wxString GetDescription();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 // Implementación de los Comandos
 ///////////////////////////////////////////////////////////////////////////////
+
+// The commands are only executed, undo and redo restore the snapshots kept by
+// the CommandProcessor
+
+// Consecutive edits of the same property within this interval are undone together
+#define HISTORY_MERGE_INTERVAL 1500
+
+/**
+ * Name of an object for the history descriptions.
+ */
+static wxString GetObjectDescription( PObjectBase obj )
+{
+	if ( !obj )
+	{
+		return wxEmptyString;
+	}
+
+	// Sizer items are described by the object they hold
+	if ( obj->GetObjectInfo()->GetObjectType()->IsItem() && obj->GetChildCount() > 0 )
+	{
+		obj = obj->GetChild( 0 );
+	}
+
+	PProperty name = obj->GetProperty( wxT( "name" ) );
+	if ( name && !name->GetValue().empty() )
+	{
+		return name->GetValue();
+	}
+
+	return obj->GetClassName();
+}
+
 ExpandObjectCmd::ExpandObjectCmd( PObjectBase object, bool expand )
 		: m_object( object ), m_expand( expand )
 {
@@ -243,16 +280,15 @@ void ExpandObjectCmd::DoExecute()
 	m_object->SetExpanded( m_expand );
 }
 
-void ExpandObjectCmd::DoRestore()
+wxString ExpandObjectCmd::GetDescription()
 {
-	m_object->SetExpanded( !m_expand );
+	return wxString::Format( m_expand ? _( "Expand %s" ) : _( "Collapse %s" ), GetObjectDescription( m_object ).c_str() );
 }
 
 InsertObjectCmd::InsertObjectCmd( ApplicationData *data, PObjectBase object,
                                   PObjectBase parent, int pos )
 		: m_data( data ), m_parent( parent ), m_object( object ), m_pos( pos )
 {
-	m_oldSelected = data->GetSelectedObject();
 }
 
 void InsertObjectCmd::DoExecute()
@@ -263,6 +299,8 @@ void InsertObjectCmd::DoExecute()
 	if ( m_pos >= 0 )
 		m_parent->ChangeChildPosition( m_object, m_pos );
 
+	m_data->IndexSubtreeNames( m_object, true );
+
 	PObjectBase obj = m_object;
 	while ( obj && obj->GetObjectInfo()->GetObjectType()->IsItem() )
 	{
@@ -274,11 +312,9 @@ void InsertObjectCmd::DoExecute()
 	m_data->SelectObject( obj, false, false );
 }
 
-void InsertObjectCmd::DoRestore()
+wxString InsertObjectCmd::GetDescription()
 {
-	m_parent->RemoveChild( m_object );
-	m_object->SetParent( PObjectBase() );
-	m_data->SelectObject( m_oldSelected );
+	return wxString::Format( _( "Insert %s" ), GetObjectDescription( m_object ).c_str() );
 }
 
 //-----------------------------------------------------------------------------
@@ -289,60 +325,75 @@ RemoveObjectCmd::RemoveObjectCmd( ApplicationData *data, PObjectBase object )
 	m_object = object;
 	m_parent = object->GetParent();
 	m_oldPos = m_parent->GetChildPosition( object );
-	m_oldSelected = data->GetSelectedObject();
 }
 
 void RemoveObjectCmd::DoExecute()
 {
+	m_data->IndexSubtreeNames( m_object, false );
 	m_parent->RemoveChild( m_object );
 	m_object->SetParent( PObjectBase() );
 	m_data->DetermineObjectToSelect( m_parent, m_oldPos );
 }
 
-void RemoveObjectCmd::DoRestore()
+wxString RemoveObjectCmd::GetDescription()
 {
-	m_parent->AddChild( m_object );
-	m_object->SetParent( m_parent );
-
-	// restauramos la posición
-	m_parent->ChangeChildPosition( m_object, m_oldPos );
-	m_data->SelectObject( m_oldSelected, true, false );
+	return wxString::Format( _( "Delete %s" ), GetObjectDescription( m_object ).c_str() );
 }
 
 //-----------------------------------------------------------------------------
 
-ModifyPropertyCmd::ModifyPropertyCmd( PProperty prop, wxString value )
-		: m_property( prop ), m_newValue( value )
+ModifyPropertyCmd::ModifyPropertyCmd( ApplicationData *data, PProperty prop, wxString value )
+		: m_data( data ), m_property( prop ), m_value( value )
 {
-	m_oldValue = prop->GetValue();
+	m_time = wxGetLocalTimeMillis();
 }
 
 void ModifyPropertyCmd::DoExecute()
 {
-	m_property->SetValue( m_newValue );
+	wxString oldValue = m_property->GetValue();
+	m_property->SetValue( m_value );
+
+	if ( m_property->GetName() == wxT( "name" ) )
+		m_data->IndexRename( m_property->GetObject(), oldValue, m_value );
+}
+
+bool ModifyPropertyCmd::Merge( Command* next )
+{
+	ModifyPropertyCmd* modify = dynamic_cast< ModifyPropertyCmd* >( next );
+
+	if ( !modify || modify->m_property != m_property )
+		return false;
+
+	if ( modify->m_time - m_time > HISTORY_MERGE_INTERVAL )
+		return false;
+
+	// The snapshot of this step is taken when it is left, so it already
+	// holds the newest value
+	m_value = modify->m_value;
+	m_time = modify->m_time;
+	return true;
 }
 
-void ModifyPropertyCmd::DoRestore()
+wxString ModifyPropertyCmd::GetDescription()
 {
-	m_property->SetValue( m_oldValue );
+	return wxString::Format( _( "Change %s of %s" ), m_property->GetName().c_str(), GetObjectDescription( m_property->GetObject() ).c_str() );
 }
 
 //-----------------------------------------------------------------------------
 
 ModifyEventHandlerCmd::ModifyEventHandlerCmd( PEvent event, wxString value )
-		: m_event( event ), m_newValue( value )
+		: m_event( event ), m_value( value )
 {
-	m_oldValue = event->GetValue();
 }
 
 void ModifyEventHandlerCmd::DoExecute()
 {
-	m_event->SetValue( m_newValue );
+	m_event->SetValue( m_value );
 }
 
-void ModifyEventHandlerCmd::DoRestore()
+wxString ModifyEventHandlerCmd::GetDescription()
 {
-	m_event->SetValue( m_oldValue );
+	return wxString::Format( _( "Change %s handler" ), m_event->GetName().c_str() );
 }
 
 //-----------------------------------------------------------------------------
@@ -367,13 +418,9 @@ void ShiftChildCmd::DoExecute()
 	}
 }
 
-void ShiftChildCmd::DoRestore()
+wxString ShiftChildCmd::GetDescription()
 {
-	if ( m_oldPos != m_newPos )
-	{
-		PObjectBase parent ( m_object->GetParent() );
-		parent->ChangeChildPosition( m_object, m_oldPos );
-	}
+	return wxString::Format( _( "Move %s" ), GetObjectDescription( m_object ).c_str() );
 }
 
 //-----------------------------------------------------------------------------
@@ -384,7 +431,6 @@ CutObjectCmd::CutObjectCmd( ApplicationData *data, PObjectBase object )
 	m_object = object;
 	m_parent = object->GetParent();
 	m_oldPos = m_parent->GetChildPosition( object );
-	m_oldSelected = data->GetSelectedObject();
 }
 
 void CutObjectCmd::DoExecute()
@@ -393,24 +439,15 @@ void CutObjectCmd::DoExecute()
 	//m_clipboard = m_data->GetClipboardObject();
 
 	m_data->SetClipboardObject( m_object );
+	m_data->IndexSubtreeNames( m_object, false );
 	m_parent->RemoveChild( m_object );
 	m_object->SetParent( PObjectBase() );
 	m_data->DetermineObjectToSelect( m_parent, m_oldPos );
 }
 
-void CutObjectCmd::DoRestore()
+wxString CutObjectCmd::GetDescription()
 {
-	// reubicamos el objeto donde estaba
-	m_parent->AddChild( m_object );
-	m_object->SetParent( m_parent );
-	m_parent->ChangeChildPosition( m_object, m_oldPos );
-
-
-
-	// restauramos el clipboard
-	//m_data->SetClipboardObject(m_clipboard);
-	m_data->SetClipboardObject( PObjectBase() );
-	m_data->SelectObject( m_oldSelected, true, false );
+	return wxString::Format( _( "Cut %s" ), GetObjectDescription( m_object ).c_str() );
 }
 
 //-----------------------------------------------------------------------------
@@ -420,7 +457,6 @@ ReparentObjectCmd ::ReparentObjectCmd ( PObjectBase sizeritem, PObjectBase sizer
 	m_sizeritem = sizeritem;
 	m_sizer = sizer;
 	m_oldSizer = m_sizeritem->GetParent();
-	m_oldPosition = m_oldSizer->GetChildPosition(sizeritem);
 }
 
 void ReparentObjectCmd::DoExecute()
@@ -430,12 +466,9 @@ void ReparentObjectCmd::DoExecute()
 	m_sizer->AddChild( m_sizeritem );
 }
 
-void ReparentObjectCmd::DoRestore()
+wxString ReparentObjectCmd::GetDescription()
 {
-	m_sizer->RemoveChild( m_sizeritem );
-	m_sizeritem->SetParent( m_oldSizer );
-	m_oldSizer->AddChild( m_sizeritem );
-	m_oldSizer->ChangeChildPosition( m_sizeritem, m_oldPosition);
+	return wxString::Format( _( "Move %s to %s" ), GetObjectDescription( m_sizeritem ).c_str(), GetObjectDescription( m_sizer ).c_str() );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -461,10 +494,10 @@ void ApplicationData::Destroy()
 	s_instance = NULL;
 }
 
-void ApplicationData::Initialize()
+void ApplicationData::Initialize( bool headless )
 {
 	ApplicationData* appData = ApplicationData::Get();
-	appData->LoadApp();
+	appData->LoadApp( headless );
 }
 
 ApplicationData::ApplicationData( const wxString &rootdir )
@@ -475,18 +508,26 @@ ApplicationData::ApplicationData( const wxString &rootdir )
 		m_objDb( new ObjectDatabase() ),
 		m_manager( new wxFBManager ),
 		m_ipc( new wxFBIPC ),
+		m_canPasteFromClipboard( false ),
+		m_canPasteFromClipboardTime( 0 ),
+		m_clipboardOpens( 0 ),
+		m_clipboardOpensStart( 0 ),
 		m_fbpVerMajor( 1 ),
 		m_fbpVerMinor( 13 )
 {
 	#ifdef __WXFB_DEBUG__
 	//wxLog* log = wxLog::SetActiveTarget( NULL );
-	m_debugLogTarget = new wxLogWindow( NULL, wxT( "Logging" ) );
+	m_debugLogTarget = ( wxTheApp && wxTheApp->IsGUI() ? new wxLogWindow( NULL, wxT( "Logging" ) ) : NULL );
 	//wxLog::SetActiveTarget( log );
 	#endif
 	m_objDb->SetXmlPath( m_rootDir + wxFILE_SEP_PATH + wxT( "xml" ) + wxFILE_SEP_PATH ) ;
 	m_objDb->SetIconPath( m_rootDir + wxFILE_SEP_PATH + wxT( "resources" ) + wxFILE_SEP_PATH + wxT( "icons" ) + wxFILE_SEP_PATH );
 	m_objDb->SetPluginPath( m_rootDir + wxFILE_SEP_PATH + wxT( "plugins" ) + wxFILE_SEP_PATH ) ;
 
+	wxString cachePath = wxStandardPaths::Get().GetUserLocalDataDir();
+	cachePath.Replace( wxTheApp->GetAppName().c_str(), wxT( "wxformbuilder" ) );
+	m_objDb->SetIconCachePath( cachePath + wxFILE_SEP_PATH + wxT( "iconcache" ) );
+
 	// Support loading files from memory
 	// Used to load the XRC preview, but could be useful elsewhere
 	wxFileSystem::AddHandler( new wxMemoryFSHandler );
@@ -504,13 +545,25 @@ ApplicationData::~ApplicationData()
 	#endif
 }
 
-void ApplicationData::LoadApp()
+void ApplicationData::LoadApp( bool headless )
 
 {
-	wxString bitmapPath = m_objDb->GetXmlPath() + wxT( "icons.xml" );
-	AppBitmaps::LoadBitmaps( bitmapPath, m_objDb->GetIconPath() );
+	if ( headless )
+	{
+		m_objDb->SetLoadIcons( false );
+	}
+	else
+	{
+		wxString bitmapPath = m_objDb->GetXmlPath() + wxT( "icons.xml" );
+		AppBitmaps::LoadBitmaps( bitmapPath, m_objDb->GetIconPath() );
+	}
 	m_objDb->LoadObjectTypes();
 	m_objDb->LoadPlugins( m_manager );
+	m_objDb->LoadIcons();
+
+	// Memory budget of the undo/redo history in KiB, 0 means unlimited
+	long historyLimit = wxConfigBase::Get()->Read( wxT( "/history/memory_limit" ), 64 * 1024L );
+	m_cmdProc.SetMemoryLimit( historyLimit > 0 ? (size_t)historyLimit * 1024 : 0 );
 }
 
 PwxFBManager ApplicationData::GetManager()
@@ -540,18 +593,100 @@ PObjectBase ApplicationData::GetProjectData()
 	return m_project;
 }
 
-void ApplicationData::BuildNameSet( PObjectBase obj, PObjectBase top, std::set< wxString >& name_set )
+ApplicationData::NameIndex& ApplicationData::GetNameIndex( PObjectBase form )
 {
-	if ( obj != top )
+	NameIndexMap::iterator it = m_nameIndex.find( form.get() );
+	if ( it != m_nameIndex.end() )
+		return it->second;
+
+	NameIndex& index = m_nameIndex[ form.get() ];
+	IndexNames( form, index, true );
+	return index;
+}
+
+void ApplicationData::IndexNames( PObjectBase obj, NameIndex& index, bool add )
+{
+	PProperty nameProp = obj->GetProperty( wxT( "name" ) );
+
+	if ( nameProp )
 	{
-		PProperty nameProp = top->GetProperty( wxT( "name" ) );
+		if ( add )
+		{
+			index.names[ nameProp->GetValue() ]++;
+		}
+		else
+		{
+			std::map< wxString, unsigned int >::iterator it = index.names.find( nameProp->GetValue() );
+			if ( it != index.names.end() && --it->second == 0 )
+				index.names.erase( it );
+		}
+	}
+
+	for ( unsigned int i = 0; i < obj->GetChildCount(); i++ )
+		IndexNames( obj->GetChild( i ), index, add );
+}
+
+void ApplicationData::IndexSubtreeNames( PObjectBase obj, bool add )
+{
+	PObjectBase parent = obj->GetParent();
+
+	if ( parent && parent == m_project )
+	{
+		// A form: its index is built on demand, but it must be dropped when the
+		// form leaves the project since the object may be destroyed afterwards
+		if ( !add )
+			m_nameIndex.erase( obj.get() );
 
-		if ( nameProp )
-			name_set.insert( nameProp->GetValue() );
+		return;
 	}
 
-	for ( unsigned int i = 0; i < top->GetChildCount(); i++ )
-		BuildNameSet( obj, top->GetChild( i ), name_set );
+	PObjectBase form = obj->FindParentForm();
+	if ( !form )
+		return;
+
+	NameIndexMap::iterator it = m_nameIndex.find( form.get() );
+	if ( it != m_nameIndex.end() )
+		IndexNames( obj, it->second, add );
+}
+
+void ApplicationData::IndexRename( PObjectBase obj, const wxString& oldName, const wxString& newName )
+{
+	if ( !obj || obj == m_project || oldName == newName )
+		return;
+
+	PObjectBase form = ( obj->GetParent() == m_project ? obj : obj->FindParentForm() );
+	if ( !form )
+		return;
+
+	NameIndexMap::iterator it = m_nameIndex.find( form.get() );
+	if ( it == m_nameIndex.end() )
+		return;
+
+	std::map< wxString, unsigned int >& names = it->second.names;
+
+	std::map< wxString, unsigned int >::iterator name = names.find( oldName );
+	if ( name != names.end() && --name->second == 0 )
+		names.erase( name );
+
+	names[ newName ]++;
+}
+
+unsigned int ApplicationData::CountName( PObjectBase top, const wxString& name )
+{
+	if ( top != m_project )
+	{
+		NameIndex& index = GetNameIndex( top );
+		std::map< wxString, unsigned int >::iterator it = index.names.find( name );
+		return ( it != index.names.end() ? it->second : 0 );
+	}
+
+	// Forms must be unique in the whole project
+	unsigned int count = ( m_project->GetPropertyAsString( wxT( "name" ) ) == name ? 1 : 0 );
+
+	for ( unsigned int i = 0; i < m_project->GetChildCount(); i++ )
+		count += CountName( m_project->GetChild( i ), name );
+
+	return count;
 }
 
 void ApplicationData::ResolveNameConflict( PObjectBase obj )
@@ -579,26 +714,24 @@ void ApplicationData::ResolveNameConflict( PObjectBase obj )
 	if ( !top )
 		top = m_project; // el objeto es un form.
 
-	// construimos el conjunto de nombres
-	std::set<wxString> name_set;
-
-	BuildNameSet( obj, top, name_set );
-
-	// comprobamos si hay conflicto
-	std::set<wxString>::iterator it = name_set.find( originalName );
+	// the object is already inserted, so it is counted once in the index
+	if ( CountName( top, originalName ) <= 1 )
+		return;
 
-	int i = 0;
+	NameIndex& scope = ( top == m_project ? m_formNameIndex : GetNameIndex( top ) );
+	int& counter = scope.counters[ originalName ];
 
-	wxString name = originalName; // The name that gets incremented.
+	wxString name; // The name that gets incremented.
 
-	while ( it != name_set.end() )
+	do
 	{
-		i++;
-		name = wxString::Format( wxT( "%s%i" ), originalName.c_str(), i );
-		it = name_set.find( name );
+		counter++;
+		name = wxString::Format( wxT( "%s%i" ), originalName.c_str(), counter );
 	}
+	while ( CountName( top, name ) > 0 );
 
 	nameProp->SetValue( name );
+	IndexRename( obj, originalName, name );
 }
 
 void ApplicationData::ResolveSubtreeNameConflicts( PObjectBase obj, PObjectBase topObj )
@@ -901,34 +1034,52 @@ void ApplicationData::DetermineObjectToSelect( PObjectBase parent, unsigned int
 	SelectObject( objToSelect );
 }
 
+bool ApplicationData::OpenClipboard()
+{
+	// Do not call Open() when the clipboard is opened
+	if ( wxTheClipboard->IsOpened() )
+	{
+		return true;
+	}
+
+	wxLongLong now = wxGetLocalTimeMillis();
+	if ( now - m_clipboardOpensStart >= 60000 )
+	{
+		if ( m_clipboardOpens > 0 )
+		{
+			LogDebug( wxT( "Clipboard opened %u times in the last minute" ), m_clipboardOpens );
+		}
+		m_clipboardOpens = 0;
+		m_clipboardOpensStart = now;
+	}
+	++m_clipboardOpens;
+
+	return wxTheClipboard->Open();
+}
+
 void ApplicationData::CopyObjectToClipboard( PObjectBase obj )
 {
 	// Write some text to the clipboard
-
-	// Do not call Open() when the clipboard is opened
-	if( !wxTheClipboard->IsOpened() )
+	if ( !OpenClipboard() )
 	{
-        if ( !wxTheClipboard->Open() )
-        {
-            return;
-        }
+		return;
 	}
 
     // This data objects are held by the clipboard,
     // so do not delete them in the app.
     wxTheClipboard->SetData( new wxFBDataObject( obj ) );
     wxTheClipboard->Close();
+
+	// Our own data is on the clipboard now
+	m_canPasteFromClipboard = true;
+	m_canPasteFromClipboardTime = wxGetLocalTimeMillis();
 }
 
 bool ApplicationData::PasteObjectFromClipboard( PObjectBase parent )
 {
-	// Do not call Open() when the clipboard is opened
-	if( !wxTheClipboard->IsOpened() )
+	if ( !OpenClipboard() )
 	{
-        if ( !wxTheClipboard->Open() )
-        {
-            return false;
-        }
+		return false;
 	}
 
     if ( wxTheClipboard->IsSupported( wxFBDataObjectFormat ) )
@@ -952,21 +1103,26 @@ bool ApplicationData::PasteObjectFromClipboard( PObjectBase parent )
 
 bool ApplicationData::CanPasteObjectFromClipboard()
 {
-	// Do not call Open() when the clipboard is opened
-	if( !wxTheClipboard->IsOpened() )
+	// Check again at most once a second, copies from this process and
+	// activations of the main frame reset the cache immediately
+	wxLongLong now = wxGetLocalTimeMillis();
+	if ( m_canPasteFromClipboardTime != 0 && now - m_canPasteFromClipboardTime < 1000 )
 	{
-        if ( !wxTheClipboard->Open() )
-        {
-            return false;
-        }
+		return m_canPasteFromClipboard;
+	}
+
+	if ( !OpenClipboard() )
+	{
+		return false;
 	}
 
-	bool canPaste = wxTheClipboard->IsSupported( wxFBDataObjectFormat );
+	m_canPasteFromClipboard = wxTheClipboard->IsSupported( wxFBDataObjectFormat );
+	m_canPasteFromClipboardTime = now;
 
 	if( wxTheClipboard->IsOpened() )
 		wxTheClipboard->Close();
 
-	return canPaste;
+	return m_canPasteFromClipboard;
 }
 
 void ApplicationData::CopyObject( PObjectBase obj )
@@ -1198,7 +1354,7 @@ void ApplicationData::ModifyProperty( PProperty prop, wxString str )
 
 	if ( str != prop->GetValue() )
 	{
-		PCommand command( new ModifyPropertyCmd( prop, str ) );
+		PCommand command( new ModifyPropertyCmd( this, prop, str ) );
 		Execute( command ); //m_cmdProc.Execute(command);
 
 		NotifyPropertyModified( prop );
@@ -1220,6 +1376,8 @@ void ApplicationData::ModifyEventHandler( PEvent evt, wxString value )
 
 void ApplicationData::SaveProject( const wxString& filename )
 {
+	TRACE_SCOPE_DETAIL( "project", "ApplicationData::SaveProject", filename );
+
 	// Make sure this file is not already open
 
 	if ( !m_ipc->VerifySingleInstance( filename, false ) )
@@ -1261,6 +1419,8 @@ void ApplicationData::SaveProject( const wxString& filename )
 bool ApplicationData::LoadProject( const wxString &file, bool justGenerate )
 
 {
+	TRACE_SCOPE_DETAIL( "project", "ApplicationData::LoadProject", file );
+
 	LogDebug( wxT( "LOADING" ) );
 
 	if ( !wxFileName::FileExists( file ) )
@@ -1375,7 +1535,9 @@ bool ApplicationData::LoadProject( const wxString &file, bool justGenerate )
 			m_project = proj;
 			m_selObj = m_project;
 			m_modFlag = false;
-			m_cmdProc.Reset();
+			m_cmdProc.Reset( m_project );
+			m_nameIndex.clear();
+			m_formNameIndex = NameIndex();
 			m_projectFile = file;
 			SetProjectPath( ::wxPathOnly( file ) );
 			NotifyProjectLoaded();
@@ -2100,7 +2262,9 @@ void ApplicationData::NewProject()
 	m_project = m_objDb->CreateObject( "Project" );
 	m_selObj = m_project;
 	m_modFlag = false;
-	m_cmdProc.Reset();
+	m_cmdProc.Reset( m_project );
+	m_nameIndex.clear();
+	m_formNameIndex = NameIndex();
 	m_projectFile = wxT( "" );
 	SetProjectPath( wxT( "" ) );
 	m_ipc->Reset();
@@ -2116,6 +2280,144 @@ void ApplicationData::GenerateCode( bool panelOnly, bool noDelayed )
 #endif
 }
 
+CodeGenerationProject::CodeGenerationProject( bool panelOnly )
+:
+m_panelOnly( panelOnly )
+{
+}
+
+CodeGenerationProject::~CodeGenerationProject()
+{
+	if ( m_times.empty() )
+	{
+		return;
+	}
+
+	wxString times;
+	for ( size_t i = 0; i < m_times.size(); ++i )
+	{
+		times << ( i > 0 ? wxT(", ") : wxT("") ) << m_times[i].first << wxString::Format( wxT(" %ld ms"), m_times[i].second );
+	}
+	wxLogVerbose( wxT("Code generation: %s."), times.c_str() );
+}
+
+PObjectBase CodeGenerationProject::GetProject()
+{
+	if ( m_project || !AppData()->GetProjectData() )
+	{
+		return m_project;
+	}
+
+	wxStopWatch watch;
+
+	// Create copy of the original project due to possible temporary modifications
+	m_project = PObjectBase( new ObjectBase( *AppData()->GetProjectData() ) );
+
+	// For code preview generate only code relevant to selected form,
+	// otherwise generate full project code.
+	PObjectBase form = ( m_panelOnly ? AppData()->GetSelectedForm() : PObjectBase() );
+	if ( form )
+	{
+		// If only one project item should be generated then remove the rest items
+		// from the temporary project
+		unsigned int i = 0;
+		while ( m_project->GetChildCount() > 1 )
+		{
+			if ( m_project->GetChild( i ) != form )
+			{
+				m_project->RemoveChild( i );
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	AddTime( wxT("project copied"), watch.Time() );
+	return m_project;
+}
+
+std::shared_ptr< ProjectAnalysis > CodeGenerationProject::GetAnalysis()
+{
+	if ( !m_analysis && GetProject() )
+	{
+		m_analysis.reset( new ProjectAnalysis( m_project ) );
+		AddTime( wxT("project analysed"), m_analysis->GetTime() );
+	}
+	return m_analysis;
+}
+
+void CodeGenerationProject::AddTime( const wxString& phase, long milliseconds )
+{
+	m_times.push_back( std::make_pair( phase, milliseconds ) );
+}
+
+std::shared_ptr< CodeGenerationProject > CodeGenerationProject::FromEvent( wxFBEvent& event )
+{
+	wxFBCodeGenerationEvent* codeGeneration = dynamic_cast< wxFBCodeGenerationEvent* >( &event );
+	if ( codeGeneration && codeGeneration->GetProject() )
+	{
+		return codeGeneration->GetProject();
+	}
+
+	// Using the previously unused Id field in the event to carry a boolean
+	return std::shared_ptr< CodeGenerationProject >( new CodeGenerationProject( event.GetId() != 0 ) );
+}
+
+bool ApplicationData::GenerateCodeFiles()
+{
+	if ( !m_project )
+	{
+		return false;
+	}
+
+	// Same as the code panels: work on a copy, the generators may modify it temporarily
+	PObjectBase project = PObjectBase( new ObjectBase( *m_project ) );
+
+	wxString path;
+	try
+	{
+		path = GetOutputPath();
+	}
+	catch ( wxFBException& ex )
+	{
+		wxLogWarning( ex.what() );
+		return false;
+	}
+
+	ProjectCodeGenerator codegen( project, path );
+	return codegen.GenerateCode();
+}
+
+bool ApplicationData::GenerateCodeFiles( const wxString& file, const wxString& languages )
+{
+	wxStopWatch watch;
+
+	if ( !LoadProject( file, true ) )
+	{
+		wxLogError( wxT("Unable to load project: %s"), file.c_str() );
+		return false;
+	}
+
+	long loadTime = watch.Time();
+
+	if ( !languages.empty() )
+	{
+		PProperty codeGen = m_project->GetProperty( wxT("code_generation") );
+		if ( codeGen )
+		{
+			codeGen->SetValue( languages );
+		}
+	}
+
+	bool result = GenerateCodeFiles();
+
+	wxLogMessage( _("Project loaded in %ld ms, code generated in %ld ms."), loadTime, watch.Time() - loadTime );
+
+	return result;
+}
+
 void ApplicationData::GenerateInheritedClass( PObjectBase form, wxString className, wxString path, wxString file )
 {
 	try
@@ -2339,17 +2641,66 @@ void ApplicationData::MoveHierarchy( PObjectBase obj, bool up )
 
 void ApplicationData::Undo()
 {
-	m_cmdProc.Undo();
-	m_modFlag = !m_cmdProc.IsAtSavePoint();
-	NotifyProjectRefresh();
-	CheckProjectTree( m_project );
-	NotifyObjectSelected( GetSelectedObject() );
+	if ( m_cmdProc.CanUndo() )
+		GoToHistory( m_cmdProc.GetHistoryPosition() - 1 );
 }
 
 void ApplicationData::Redo()
 {
-	m_cmdProc.Redo();
+	if ( m_cmdProc.CanRedo() )
+		GoToHistory( m_cmdProc.GetHistoryPosition() + 1 );
+}
+
+wxString ApplicationData::GetHistoryDescription( size_t step )
+{
+	return m_cmdProc.GetDescription( step );
+}
+
+/**
+ * Whether the object is linked to the project, directly or through its ancestors.
+ */
+static bool IsInProject( PObjectBase obj, PObjectBase project )
+{
+	while ( obj && obj != project )
+		obj = obj->GetParent();
+
+	return ( obj && obj == project );
+}
+
+void ApplicationData::GoToHistory( size_t position )
+{
+	if ( position == m_cmdProc.GetHistoryPosition() || position > m_cmdProc.GetHistoryCount() )
+	{
+		return;
+	}
+
+	std::vector< PObjectBase > restored;
+	m_cmdProc.GoTo( position, GetSelectedObject(), &restored );
 	m_modFlag = !m_cmdProc.IsAtSavePoint();
+
+	// The changed objects include the forms holding them, their name indexes
+	// are rebuilt on demand. Those of the forms out of the project are dropped.
+	for ( std::vector< PObjectBase >::iterator obj = restored.begin(); obj != restored.end(); ++obj )
+		m_nameIndex.erase( obj->get() );
+
+	for ( NameIndexMap::iterator it = m_nameIndex.begin(); it != m_nameIndex.end(); )
+	{
+		if ( it->first->GetParent() != m_project )
+			m_nameIndex.erase( it++ );
+		else
+			++it;
+	}
+
+	// A cut object back in the project can't be pasted
+	if ( m_clipboard && IsInProject( m_clipboard, m_project ) )
+		m_clipboard.reset();
+
+	PObjectBase selected = m_cmdProc.GetSelected();
+	if ( !IsInProject( selected, m_project ) )
+		selected = m_project;
+
+	// Refresh once, whatever the number of steps
+	SelectObject( selected, true, false );
 	NotifyProjectRefresh();
 	CheckProjectTree( m_project );
 	NotifyObjectSelected( GetSelectedObject() );
@@ -2703,7 +3054,27 @@ bool ApplicationData::IsModified()
 void ApplicationData::Execute( PCommand cmd )
 {
 	m_modFlag = true;
-	m_cmdProc.Execute( cmd );
+	m_cmdProc.Execute( cmd, GetSelectedObject() );
+}
+
+wxString ApplicationData::GetHistoryReport()
+{
+	wxString report = wxString::Format( wxT( "History: %lu undo / %lu redo steps, %.1f KiB" ),
+	                                    (unsigned long)m_cmdProc.GetUndoCount(),
+	                                    (unsigned long)m_cmdProc.GetRedoCount(),
+	                                    m_cmdProc.GetMemoryUsage() / 1024.0 );
+
+	if ( m_cmdProc.GetMemoryLimit() > 0 )
+	{
+		report << wxString::Format( wxT( " of %.1f KiB" ), m_cmdProc.GetMemoryLimit() / 1024.0 );
+	}
+
+	if ( m_cmdProc.GetDiscardedCount() > 0 )
+	{
+		report << wxString::Format( wxT( ", %lu oldest steps discarded" ), (unsigned long)m_cmdProc.GetDiscardedCount() );
+	}
+
+	return report;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -2726,6 +3097,7 @@ void ApplicationData::RemoveHandler( wxEvtHandler* handler )
 
 void ApplicationData::NotifyEvent( wxFBEvent& event, bool forcedelayed )
 {
+	TRACE_SCOPE_DETAIL( "events", "ApplicationData::NotifyEvent", event.GetEventName() );
 
 	if ( !forcedelayed )
 	{
@@ -2803,7 +3175,9 @@ void ApplicationData::NotifyEventHandlerModified( PEvent evtHandler )
 
 void ApplicationData::NotifyCodeGeneration( bool panelOnly, bool forcedelayed )
 {
-	wxFBEvent event( wxEVT_FB_CODE_GENERATION );
+	// Every code panel generates from the same copy and analysis of the project
+	std::shared_ptr< CodeGenerationProject > project( new CodeGenerationProject( panelOnly ) );
+	wxFBCodeGenerationEvent event( wxEVT_FB_CODE_GENERATION, project );
 
 	// Using the previously unused Id field in the event to carry a boolean
 	event.SetId( ( panelOnly ? 1 : 0 ) );
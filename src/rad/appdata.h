@@ -47,11 +47,51 @@ class wxFBManager;
 
 class wxFBIPC;
 
+class ProjectAnalysis;
+
 #define AppData()         	(ApplicationData::Get())
 #define AppDataCreate(path) (ApplicationData::Get(path))
 #define AppDataInit()	      (ApplicationData::Initialize())
+#define AppDataInitHeadless() (ApplicationData::Initialize( true ))
 #define AppDataDestroy()  	(ApplicationData::Destroy())
 
+/**
+ * Copy of the project and its analysis, shared by the code panels handling the
+ * same code generation event, so the project is copied and walked only once for
+ * the previews and the files of every language. Both are created on first use.
+ * The time of each phase is logged when the last panel is done with it.
+ */
+class CodeGenerationProject
+{
+private:
+	bool m_panelOnly;
+	PObjectBase m_project;
+	std::shared_ptr< ProjectAnalysis > m_analysis;
+	std::vector< std::pair< wxString, long > > m_times; // phase, milliseconds
+
+public:
+	/**
+	 * @param panelOnly Only the selected form is copied, for the code previews.
+	 */
+	CodeGenerationProject( bool panelOnly );
+	~CodeGenerationProject();
+
+	/**
+	 * The copy of the project, which the generators may modify temporarily.
+	 */
+	PObjectBase GetProject();
+
+	std::shared_ptr< ProjectAnalysis > GetAnalysis();
+
+	void AddTime( const wxString& phase, long milliseconds );
+
+	/**
+	 * The one carried by a code generation event, or a new one for the other
+	 * events which refresh the code panels.
+	 */
+	static std::shared_ptr< CodeGenerationProject > FromEvent( wxFBEvent& event );
+};
+
 // This class is a singleton class.
 
 class ApplicationData
@@ -89,6 +129,17 @@ class ApplicationData
 		// Prevent more than one instance of a project
 		std::shared_ptr< wxFBIPC > m_ipc;
 
+		// Checking the clipboard formats opens the system clipboard, a round-trip to the X server,
+		// so the result is kept for a while instead of checking on every update UI event
+		bool m_canPasteFromClipboard;
+		wxLongLong m_canPasteFromClipboardTime;	// when it was checked, 0 to check again
+
+		// Clipboard opens in the current minute, logged in debug builds
+		unsigned int m_clipboardOpens;
+		wxLongLong m_clipboardOpensStart;
+
+		bool OpenClipboard();
+
 
 		typedef std::vector< wxEvtHandler* > HandlerVector;
 
@@ -135,9 +186,38 @@ class ApplicationData
 		void ResolveSubtreeNameConflicts( PObjectBase obj, PObjectBase topObj = PObjectBase() );
 
 		/**
-		 * Rutina auxiliar de ResolveNameConflict
+		 * Names used inside a form and the last numeric suffix handed out for
+		 * each base name, kept up to date by the commands so conflicts can be
+		 * resolved without walking the whole form.
+		 */
+		class NameIndex
+		{
+		public:
+			std::map< wxString, unsigned int > names; // name -> number of objects using it
+			std::map< wxString, int > counters;       // base name -> last suffix used
+		};
+
+		typedef std::map< ObjectBase*, NameIndex > NameIndexMap;
+
+		NameIndexMap m_nameIndex;   // built lazily, one entry per form
+
+		NameIndex m_formNameIndex;  // only the counters are used, for the forms themselves
+
+		/**
+		 * Returns the index of a form, building it on first use.
+		 */
+		NameIndex& GetNameIndex( PObjectBase form );
+
+		/**
+		 * Adds (or removes) the names of a subtree to the index.
 		 */
-		void BuildNameSet( PObjectBase obj, PObjectBase top, std::set<wxString> &name_set );
+		void IndexNames( PObjectBase obj, NameIndex& index, bool add );
+
+		/**
+		 * Number of objects called @a name in the scope of @a top, which is either
+		 * a form or the project (all the forms).
+		 */
+		unsigned int CountName( PObjectBase top, const wxString& name );
 
 		/**
 		 * Calcula la posición donde deberá ser insertado el objeto.
@@ -240,12 +320,13 @@ class ApplicationData
 		static ApplicationData* Get( const wxString &rootdir = wxT( "." ) );
 
 		// Force the static AppData instance to Init()
-		static void Initialize();
+		// headless: only what is needed to generate code, no bitmaps are loaded
+		static void Initialize( bool headless = false );
 
 		static void Destroy();
 
 		// Initialize application
-		void LoadApp();
+		void LoadApp( bool headless = false );
 
 		// Hold a pointer to the wxFBManager
 		PwxFBManager GetManager();
@@ -311,6 +392,19 @@ class ApplicationData
 
 		void GenerateCode( bool panelOnly = false, bool noDelayed = false );
 
+		/**
+		 * Generates the files of all the languages enabled in the project,
+		 * without going through the code panels.
+		 * @return false if some file could not be generated.
+		 */
+		bool GenerateCodeFiles();
+
+		/**
+		 * Loads a project and generates its files, used from the command line.
+		 * @param languages If not empty, overrides the code_generation property (e.g. "C++|XRC").
+		 */
+		bool GenerateCodeFiles( const wxString& file, const wxString& languages );
+
 		void GenerateInheritedClass( PObjectBase form, wxString className, wxString path, wxString file );
 
 		void MovePosition( PObjectBase, bool right, unsigned int num = 1 );
@@ -321,6 +415,28 @@ class ApplicationData
 
 		void Redo();
 
+		/**
+		Steps of the undo/redo history, see CommandProcessor::GoTo.
+		*/
+		size_t GetHistoryCount() { return m_cmdProc.GetHistoryCount(); }
+
+		size_t GetHistoryPosition() { return m_cmdProc.GetHistoryPosition(); }
+
+		wxString GetHistoryDescription( size_t step );
+
+		/**
+		Restores the project as it was at the given position of the history and refreshes the views once.
+		*/
+		void GoToHistory( size_t position );
+
+		/**
+		 * Keep the name index up to date, used by the undo/redo commands.
+		 * IndexSubtreeNames must be called while @a obj is linked to the project.
+		 */
+		void IndexSubtreeNames( PObjectBase obj, bool add );
+
+		void IndexRename( PObjectBase obj, const wxString& oldName, const wxString& newName );
+
 		void ToggleExpandLayout( PObjectBase obj );
 
 		void ToggleStretchLayout( PObjectBase obj );
@@ -344,9 +460,19 @@ class ApplicationData
 
 		bool CanRedo() { return m_cmdProc.CanRedo(); }
 
+		/**
+		Summary of the undo/redo history size and its estimated memory usage.
+		*/
+		wxString GetHistoryReport();
+
 		bool GetLayoutSettings( PObjectBase obj, int *flag, int *option, int *border, int* orient );
 		bool CanPasteObject();
 		bool CanPasteObjectFromClipboard();
+
+		/**
+		Forget the cached clipboard state, for instance when another application may have changed it.
+		*/
+		void InvalidateClipboardCache() { m_canPasteFromClipboardTime = 0; }
 		bool CanCopyObject();
 		bool IsModified();
 
@@ -33,23 +33,24 @@
 
 #include <ticpp.h>
 
-static std::map< wxString, wxBitmap > m_bitmaps;
+// Icon files by name, from icons.xml
+static std::map< wxString, wxString > m_files;
 
-wxBitmap AppBitmaps::GetBitmap( wxString iconname, unsigned int size )
+// Loaded bitmaps by name and size, 0 is the size of the file
+static std::map< std::pair< wxString, unsigned int >, wxBitmap > m_bitmaps;
+
+static unsigned long s_hits = 0;
+static unsigned long s_misses = 0;
+
+// Loads or scales a bitmap missing from the cache, and adds it
+static wxBitmap LoadAppBitmap( const wxString& iconname, unsigned int size )
 {
-	std::map< wxString, wxBitmap >::iterator bitmap;
-	bitmap = m_bitmaps.find( iconname );
 	wxBitmap bmp;
-	if ( bitmap != m_bitmaps.end() )
-	{
-		bmp = m_bitmaps[iconname];
-	}
-	else
-	{
-		bmp = m_bitmaps[ wxT("unknown") ];
-	}
 	if ( size != 0 )
 	{
+		std::map< std::pair< wxString, unsigned int >, wxBitmap >::iterator original = m_bitmaps.find( std::make_pair( iconname, 0u ) );
+		bmp = ( original != m_bitmaps.end() ? original->second : LoadAppBitmap( iconname, 0 ) );
+
 		// rescale it to requested size
 		if ( bmp.GetWidth() != (int)size || bmp.GetHeight() != (int)size )
 		{
@@ -57,14 +58,48 @@ wxBitmap AppBitmaps::GetBitmap( wxString iconname, unsigned int size )
 			bmp = wxBitmap( image.Scale(size, size) );
 		}
 	}
+	else if ( m_files[ iconname ].empty() )
+	{
+		bmp = wxBitmap( default_xpm );
+	}
+	else
+	{
+		bmp = wxBitmap( m_files[ iconname ], wxBITMAP_TYPE_ANY );
+	}
+
+	m_bitmaps[ std::make_pair( iconname, size ) ] = bmp;
 	return bmp;
 }
 
+wxBitmap AppBitmaps::GetBitmap( wxString iconname, unsigned int size )
+{
+	if ( m_files.find( iconname ) == m_files.end() )
+	{
+		iconname = wxT("unknown");
+	}
+
+	std::map< std::pair< wxString, unsigned int >, wxBitmap >::iterator bitmap = m_bitmaps.find( std::make_pair( iconname, size ) );
+	if ( bitmap != m_bitmaps.end() )
+	{
+		++s_hits;
+		return bitmap->second;
+	}
+
+	++s_misses;
+	return LoadAppBitmap( iconname, size );
+}
+
+void AppBitmaps::GetCacheStats( unsigned long* hits, unsigned long* misses )
+{
+	*hits = s_hits;
+	*misses = s_misses;
+}
+
 void AppBitmaps::LoadBitmaps( wxString filepath, wxString iconpath )
 {
 	try
 	{
-		m_bitmaps[ wxT("unknown") ] = wxBitmap( default_xpm );
+		m_files[ wxT("unknown") ] = wxEmptyString;
 
 		ticpp::Document doc;
 		XMLUtils::LoadXMLFile( doc, true, filepath );
@@ -75,7 +110,7 @@ void AppBitmaps::LoadBitmaps( wxString filepath, wxString iconpath )
 		{
 			wxString name = _WXSTR( elem->GetAttribute("name") );
 			wxString file = _WXSTR( elem->GetAttribute("file") );
-			m_bitmaps[name] = wxBitmap( iconpath + file, wxBITMAP_TYPE_ANY );
+			m_files[name] = iconpath + file;
 
 			elem = elem->NextSiblingElement( "icon", false );
 		}
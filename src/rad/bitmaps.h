@@ -33,11 +33,22 @@
 #include <wx/wx.h>
 #include <map>
 
+/**
+ * Application icons, listed in icons.xml.
+ * The files are loaded on first use, and each requested size is scaled only
+ * once and kept.
+ */
 class AppBitmaps
 {
 public:
 	static wxBitmap GetBitmap( wxString iconname, unsigned int size = 0 );
 	static void LoadBitmaps( wxString filepath, wxString iconpath );
+
+	/**
+	 * Number of GetBitmap calls served from the cache, and of those that had
+	 * to load or scale a bitmap.
+	 */
+	static void GetCacheStats( unsigned long* hits, unsigned long* misses );
 };
 
 #endif //__WXFB__BITMAPS_H__
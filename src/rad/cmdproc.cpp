@@ -24,74 +24,162 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "cmdproc.h"
+#include "model/snapshot.h"
+
+// Marks a save point that was dropped from the history and can't be reached
+static const size_t NO_SAVE_POINT = (size_t)-1;
 
 CommandProcessor::CommandProcessor()
 :
-m_savePoint( 0 )
+m_position( 0 ),
+m_savePoint( 0 ),
+m_memoryLimit( 0 ),
+m_memoryUsage( 0 ),
+m_discarded( 0 )
 {
+  m_steps.push_back(Step());
 }
 
-void CommandProcessor::Execute(PCommand command)
+void CommandProcessor::Execute(PCommand command, PObjectBase selected)
 {
+  Leave(selected);
+  ClearRedo();
   command->Execute();
-  m_undoStack.push(command);
 
-  while (!m_redoStack.empty())
-    m_redoStack.pop();
+  // Never merge into the saved step, the modified flag depends on it
+  Step& last = m_steps.back();
+  if (last.command && !IsAtSavePoint() && last.command->Merge(command.get()))
+    return;
+
+  last.command.reset();
+
+  Step step;
+  step.command = command;
+  m_steps.push_back(step);
+  m_position++;
+  Trim();
 }
 
-void CommandProcessor::Undo()
+void CommandProcessor::Leave(PObjectBase selected)
 {
-  if (!m_undoStack.empty())
-  {
-    PCommand command = m_undoStack.top();
-    m_undoStack.pop();
+  Step& step = m_steps[m_position];
+  step.selected = selected;
+
+  if (step.command)
+    step.description = step.command->GetDescription();
+
+  if (!m_project)
+    return;
+
+  // Only the objects changed since the last snapshot get new nodes
+  size_t memoryUsage = 0;
+  PObjectSnapshot snapshot = ObjectSnapshot::Take(m_project, &memoryUsage);
+  if (snapshot == step.snapshot)
+    return;
+
+  // The oldest position is the base of the history, not counted
+  if (m_position > 0)
+    m_memoryUsage = m_memoryUsage - step.memoryUsage + memoryUsage;
+
+  step.snapshot = snapshot;
+  step.memoryUsage = memoryUsage;
+}
 
-    command->Restore();
-    m_redoStack.push(command);
+void CommandProcessor::Reset(PObjectBase project)
+{
+  m_project = project;
+  m_steps.clear();
+  m_steps.push_back(Step());
+
+  m_position = 0;
+  m_savePoint = 0;
+  m_memoryUsage = 0;
+  m_discarded = 0;
+}
+
+void CommandProcessor::ClearRedo()
+{
+  // A save point in the redo branch is lost together with it
+  if (m_savePoint != NO_SAVE_POINT && m_savePoint > m_position)
+    m_savePoint = NO_SAVE_POINT;
+
+  while (m_steps.size() > m_position + 1)
+  {
+    m_memoryUsage -= m_steps.back().memoryUsage;
+    m_steps.pop_back();
   }
 }
 
-void CommandProcessor::Redo()
+void CommandProcessor::Trim()
 {
-  if (!m_redoStack.empty())
+  if (m_memoryLimit == 0)
+    return;
+
+  while (m_memoryUsage > m_memoryLimit && m_position > 1)
   {
-    PCommand command = m_redoStack.top();
-    m_redoStack.pop();
+    m_steps.pop_front();
+    m_memoryUsage -= m_steps.front().memoryUsage;
+    m_position--;
+    m_discarded++;
 
-    command->Execute();
-    m_undoStack.push(command);
+    if (m_savePoint != NO_SAVE_POINT)
+      m_savePoint = (m_savePoint > 0 ? m_savePoint - 1 : NO_SAVE_POINT);
   }
 }
 
-void CommandProcessor::Reset()
+void CommandProcessor::SetMemoryLimit(size_t bytes)
 {
-  while (!m_redoStack.empty())
-    m_redoStack.pop();
+  m_memoryLimit = bytes;
+  Trim();
+}
 
-  while (!m_undoStack.empty())
-    m_undoStack.pop();
+wxString CommandProcessor::GetDescription(size_t step)
+{
+  if (step + 1 >= m_steps.size())
+    return wxEmptyString;
 
-  m_savePoint = 0;
+  Step& next = m_steps[step + 1];
+  return (next.command ? next.command->GetDescription() : next.description);
+}
+
+void CommandProcessor::GoTo(size_t position, PObjectBase selected, std::vector<PObjectBase>* restored)
+{
+  if (position >= m_steps.size() || position == m_position)
+    return;
+
+  Leave(selected);
+
+  // Once left, the last step can't absorb the next command any more
+  m_steps.back().command.reset();
+  m_position = position;
+
+  PObjectSnapshot snapshot = m_steps[m_position].snapshot;
+  if (snapshot)
+    ObjectSnapshot::Restore(snapshot, restored);
+}
+
+PObjectBase CommandProcessor::GetSelected()
+{
+  return m_steps[m_position].selected.lock();
 }
 
 bool CommandProcessor::CanUndo()
 {
-  return (!m_undoStack.empty());
+  return (m_position > 0);
 }
 bool CommandProcessor::CanRedo()
 {
-  return (!m_redoStack.empty());
+  return (m_position + 1 < m_steps.size());
 }
 
 void CommandProcessor::SetSavePoint()
 {
-	m_savePoint = m_undoStack.size();
+	m_savePoint = m_position;
 }
 
 bool CommandProcessor::IsAtSavePoint()
 {
-	return m_undoStack.size() == m_savePoint;
+	return m_position == m_savePoint;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -108,13 +196,3 @@ void Command::Execute()
     m_executed = true;
   }
 }
-
-void Command::Restore()
-{
-  if (m_executed)
-  {
-    DoRestore();
-    m_executed = false;
-  }
-}
-
@@ -26,34 +26,111 @@
 #ifndef __COMMAND_PROC__
 #define __COMMAND_PROC__
 
-#include <stack>
+#include "utils/wxfbdefs.h"
+#include <wx/string.h>
+#include <deque>
 #include <memory>
+#include <vector>
+#include <cstddef>
 
 class Command;
 typedef std::shared_ptr<Command> PCommand;
 
+/**
+ * Undo/redo history. Every position of the history keeps a snapshot of the
+ * project (see ObjectSnapshot), so going to any position restores it at once,
+ * touching only the objects that differ, whatever the number of steps in
+ * between. The snapshots share the objects that did not change, each step
+ * only adds the nodes of the objects it changed and their ancestors.
+ */
 class CommandProcessor
 {
  private:
-  typedef std::stack<PCommand> CommandStack;
-
-  CommandStack m_undoStack;
-  CommandStack m_redoStack;
+  struct Step
+  {
+    PObjectSnapshot snapshot; // the project when this position was last left
+    size_t memoryUsage;       // bytes of the nodes built for the snapshot
+    wxString description;     // of the change that leads to this position
+    PCommand command;         // that change, kept while it may absorb the next one
+    WPObjectBase selected;    // selected object when this position was last left
+
+    Step() : memoryUsage( 0 ) {}
+  };
+
+  PObjectBase m_project;
+  std::deque<Step> m_steps; // position n is m_steps[n], the first one is the oldest state kept
+  size_t m_position;
   size_t m_savePoint;
 
+  size_t m_memoryLimit;   // history budget in bytes, 0 = unlimited
+  size_t m_memoryUsage;   // estimated bytes held by the steps
+  size_t m_discarded;     // steps dropped to honour the budget
+
+  void ClearRedo();
+
+  /**
+   * Drops the oldest undo steps until the history fits in the budget.
+   * The most recent step is always kept.
+   */
+  void Trim();
+
+  /**
+   * Takes the snapshot of the current position before moving away from it,
+   * so it includes the changes made after its command.
+   */
+  void Leave(PObjectBase selected);
+
  public:
    CommandProcessor();
-   void Execute(PCommand command);
 
-   void Undo();
-   void Redo();
-   void Reset();
+   /**
+    * Executes the command and adds it to the history.
+    * @param selected the object selected before the command.
+    */
+   void Execute(PCommand command, PObjectBase selected);
+
+   /**
+    * Clears the history, @a project is the object its snapshots are taken of.
+    */
+   void Reset(PObjectBase project = PObjectBase());
 
    void SetSavePoint();
    bool IsAtSavePoint();
 
    bool CanUndo();
    bool CanRedo();
+
+   void SetMemoryLimit(size_t bytes);
+   size_t GetMemoryLimit() { return m_memoryLimit; }
+   size_t GetMemoryUsage() { return m_memoryUsage; }
+
+   size_t GetUndoCount() { return m_position; }
+   size_t GetRedoCount() { return m_steps.size() - m_position - 1; }
+   size_t GetDiscardedCount() { return m_discarded; }
+
+   /**
+    * The history is a sequence of steps, position n is the state after the
+    * first n steps. The current position is the number of undo steps.
+    */
+   size_t GetHistoryCount() { return m_steps.size() - 1; }
+   size_t GetHistoryPosition() { return m_position; }
+
+   /**
+    * Description of the step that goes from position @a step to @a step + 1.
+    */
+   wxString GetDescription(size_t step);
+
+   /**
+    * Restores the snapshot of the given position.
+    * @param selected the object selected before moving.
+    * @param restored if not NULL, receives the objects that were changed.
+    */
+   void GoTo(size_t position, PObjectBase selected, std::vector<PObjectBase>* restored = NULL);
+
+   /**
+    * The object that was selected when the current position was last left.
+    */
+   PObjectBase GetSelected();
 };
 
 
@@ -68,17 +145,23 @@ class Command
    */
   virtual void DoExecute() = 0;
 
-  /**
-   * Restaura el estado previo a la ejecución del comando.
-   */
-  virtual void DoRestore() = 0;
-
  public:
   Command();
   virtual ~Command() {};
 
   void Execute();
-  void Restore();
+
+  /**
+   * Tries to absorb a command executed right after this one, so both are
+   * undone as a single step.
+   * @return true if @a next was merged and must not be stored.
+   */
+  virtual bool Merge( Command* next ) { return false; }
+
+  /**
+   * Short description of the change, shown in the history.
+   */
+  virtual wxString GetDescription() = 0;
 };
 
 #endif //__COMMAND_PROC__
@@ -35,16 +35,18 @@
 #include "utils/wxfbdefs.h"
 
 #include "utils/typeconv.h"
-#include "utils/encodingutils.h"
 #include "utils/wxfbexception.h"
+#include "utils/trace.h"
 
 #include "model/objectbase.h"
 
 #include "codegen/codewriter.h"
+#include "codegen/projectcg.h"
 #include "codegen/cppcg.h"
 
 #include <wx/fdrepdlg.h>
 #include <wx/config.h>
+#include <wx/stopwatch.h>
 
 #if wxVERSION_NUMBER < 2900
     #include <wx/wxScintilla/wxscintilla.h>
@@ -280,7 +282,7 @@ void CppPanel::OnEventHandlerModified( wxFBEventHandlerEvent& event )
 
 void CppPanel::OnCodeGeneration( wxFBEvent& event )
 {
-    PObjectBase objectToGenerate;
+	TRACE_SCOPE( "panels", "CppPanel::OnCodeGeneration" );
 
 	// Generate code in the panel if the panel is active
 	bool doPanel = IsShown();
@@ -294,43 +296,15 @@ void CppPanel::OnCodeGeneration( wxFBEvent& event )
 		return;
 	}
 	
-	// For code preview generate only code relevant to selected form,
-	// otherwise generate full project code.
-
-	// Create copy of the original project due to possible temporary modifications
-	PObjectBase project = PObjectBase(new ObjectBase(*AppData()->GetProjectData()));
-
-	if(panelOnly)
-	{
-	    objectToGenerate = AppData()->GetSelectedForm();
-	}
-
-	if(!panelOnly || !objectToGenerate)
-	{
-	    objectToGenerate = project;
-	}
-
-	// If only one project item should be generated then remove the rest items
-	// from the temporary project
-	if(doPanel && panelOnly && (objectToGenerate != project))
+	// The copy of the project and its analysis are shared with the other code
+	// panels handling the same event
+	std::shared_ptr< CodeGenerationProject > shared = CodeGenerationProject::FromEvent( event );
+	PObjectBase project = shared->GetProject();
+	if ( !project )
 	{
-	    if( project->GetChildCount() > 0)
-	    {
-	        unsigned int i = 0;
-            while( project->GetChildCount() > 1 )
-            {
-                if(project->GetChild( i ) != objectToGenerate)
-                {
-                    project->RemoveChild( i );
-                }
-                else
-                    i++;
-            }
-	    }
+		return;
 	}
 
-    if(!project || !objectToGenerate)return;
-
     // Get C++ properties from the project
 
 	// If C++ generation is not enabled, do not generate the file
@@ -354,18 +328,6 @@ void CppPanel::OnCodeGeneration( wxFBEvent& event )
 		firstID = pFirstID->GetValueAsInteger();
 	}
 
-	// Get the file name
-	wxString file;
-	PProperty pfile = project->GetProperty( wxT( "file" ) );
-	if ( pfile )
-	{
-		file = pfile->GetValue();
-	}
-	if ( file.empty() )
-	{
-		file = wxT("noname");
-	}
-
 	// Determine if the path is absolute or relative
 	bool useRelativePath = false;
 	PProperty pRelPath = project->GetProperty( wxT( "relative_path" ) );
@@ -394,6 +356,7 @@ void CppPanel::OnCodeGeneration( wxFBEvent& event )
 	if ( doPanel )
 	{
 		CppCodeGenerator codegen;
+		codegen.SetAnalysis( shared->GetAnalysis() );
 		codegen.UseRelativePath( useRelativePath, path );
 
 		if ( pFirstID )
@@ -421,7 +384,9 @@ void CppPanel::OnCodeGeneration( wxFBEvent& event )
 		int hLine = hEditor->GetFirstVisibleLine() + hEditor->LinesOnScreen() - 1;
 		int hXOffset = hEditor->GetXOffset();
 
+		wxStopWatch watch;
 		codegen.GenerateCode( project );
+		shared->AddTime( wxT("C++ preview"), watch.Time() );
 
 		cppEditor->SetReadOnly( true );
 		cppEditor->GotoLine( cppLine );
@@ -441,54 +406,10 @@ void CppPanel::OnCodeGeneration( wxFBEvent& event )
 	// Generate code in the file
 	if ( doFile )
 	{
-		try
-		{
-			CppCodeGenerator codegen;
-			codegen.UseRelativePath( useRelativePath, path );
-
-			if ( pFirstID )
-			{
-				codegen.SetFirstID( firstID );
-			}
-
-			// Determin if Microsoft BOM should be used
-			bool useMicrosoftBOM = false;
-
-			PProperty pUseMicrosoftBOM = project->GetProperty( wxT( "use_microsoft_bom" ) );
-
-			if ( pUseMicrosoftBOM )
-			{
-				useMicrosoftBOM = ( pUseMicrosoftBOM->GetValueAsInteger() != 0 );
-			}
-
-			// Determine if Utf8 or Ansi is to be created
-			bool useUtf8 = false;
-			PProperty pUseUtf8 = project->GetProperty( _("encoding") );
-
-			if ( pUseUtf8 )
-			{
-				useUtf8 = ( pUseUtf8->GetValueAsString() != wxT("ANSI") );
-			}
-
-			PCodeWriter h_cw( new FileCodeWriter( path + file + wxT( ".h" ), useMicrosoftBOM, useUtf8 ) );
-
-			PCodeWriter cpp_cw( new FileCodeWriter( path + file + wxT( ".cpp" ), useMicrosoftBOM, useUtf8 ) );
-
-			codegen.SetHeaderWriter( h_cw );
-			codegen.SetSourceWriter( cpp_cw );
-			codegen.GenerateCode( project );
-			wxLogStatus( wxT( "Code generated on \'%s\'." ), path.c_str() );
-
-			// check if we have to convert to ANSI encoding
-			if (project->GetPropertyAsString(wxT("encoding")) == wxT("ANSI"))
-			{
-				UTF8ToAnsi(path + file + wxT( ".h" ));
-				UTF8ToAnsi(path + file + wxT( ".cpp" ));
-			}
-		}
-		catch ( wxFBException& ex )
-		{
-			wxLogError( ex.what() );
-		}
+		wxStopWatch watch;
+		ProjectCodeGenerator codegen( project, path );
+		codegen.SetAnalysis( shared->GetAnalysis() );
+		codegen.GenerateCode( wxT("C++") );
+		shared->AddTime( wxT("C++ files"), watch.Time() );
 	}
 }
@@ -36,6 +36,7 @@
 #include "rad/wxfbmanager.h"
 #include <rad/appdata.h>
 #include "utils/wxfbexception.h"
+#include "utils/trace.h"
 #include "model/objectbase.h"
 
 #ifdef __WX24__
@@ -59,6 +60,7 @@ BEGIN_EVENT_TABLE(VisualEditor,wxScrolledWindow)
 	EVT_FB_CODE_GENERATION( VisualEditor::OnProjectRefresh )
 
 	EVT_TIMER( ID_TIMER_SCAN, VisualEditor::OnAuiScaner )
+	EVT_IDLE( VisualEditor::OnIdle )
 
 END_EVENT_TABLE()
 
@@ -444,6 +446,8 @@ void VisualEditor::ClearComponents( wxWindow* parent )
 */
 void VisualEditor::Create()
 {
+	TRACE_SCOPE( "designer", "VisualEditor::Create" );
+
 #if !defined(__WXGTK__ )
 	if ( IsShown() )
 	{
@@ -477,6 +481,9 @@ void VisualEditor::Create()
 		{
 			m_back->Show(true);
 
+			// Images not decoded yet are shown as placeholders, OnIdle rebuilds the form once they are ready
+			TypeConv::EnableBackgroundBitmaps( true );
+
 			// --- [1] Configure the size of the form ---------------------------
 
 			// Get size properties
@@ -669,6 +676,8 @@ void VisualEditor::Create()
 				}
 			}
 
+			TypeConv::EnableBackgroundBitmaps( false );
+
 			if ( menubar || statusbar || toolbar || m_auipanel || m_wizard )
 			{
 				if( m_auimgr )
@@ -736,6 +745,8 @@ void VisualEditor::Create()
 */
 void VisualEditor::Generate( PObjectBase obj, wxWindow* wxparent, wxObject* parentObject )
 {
+	TRACE_SCOPE_DETAIL( "designer", "VisualEditor::Generate", obj->GetClassName() );
+
 	// Get Component
 	PObjectInfo obj_info = obj->GetObjectInfo();
 	IComponent* comp = obj_info->GetComponent();
@@ -1281,6 +1292,16 @@ void VisualEditor::OnProjectRefresh( wxFBEvent &)
 	Create();
 }
 
+void VisualEditor::OnIdle( wxIdleEvent& event )
+{
+	event.Skip();
+
+	if ( TypeConv::UpdateBackgroundBitmaps() )
+	{
+		Create();
+	}
+}
+
 void VisualEditor::OnAuiScaner(wxTimerEvent& event)
 {
 	if( m_auimgr )
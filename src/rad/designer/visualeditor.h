@@ -130,6 +130,7 @@ class VisualEditor : public wxScrolledWindow
   void ScanPanes( wxWindow* parent );
 
   void OnAuiScaner(wxTimerEvent& event);
+  void OnIdle( wxIdleEvent& event );
 
     void ClearWizard();
     void SetupWizard( PObjectBase obj, wxWindow* window, bool pageAdding = false );
@@ -42,6 +42,7 @@
 #include "model/objectbase.h"
 #include "utils/debug.h"
 #include "utils/typeconv.h"
+#include "utils/trace.h"
 
 #include "rad/appdata.h"
 #include "rad/bitmaps.h"
@@ -152,6 +153,8 @@ void ObjectInspector::SavePosition()
 
 void ObjectInspector::Create( bool force )
 {
+	TRACE_SCOPE( "designer", "ObjectInspector::Create" );
+
 	PObjectBase sel_obj = AppData()->GetSelectedObject();
 	if ( sel_obj && ( sel_obj != m_currentSel || force ) )
 	{
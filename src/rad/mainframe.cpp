@@ -50,6 +50,7 @@
 #include "utils/stringutils.h"
 #include "utils/wxfbdefs.h"
 #include <wx/filename.h>
+#include <wx/choicdlg.h>
 
 #include <rad/appdata.h>
 #include "model/objectbase.h"
@@ -106,6 +107,7 @@
 
 #define ID_CLIPBOARD_COPY 143
 #define ID_CLIPBOARD_PASTE 144
+#define ID_HISTORY 145
 
 //added by tyysoft to define the swap button ID.
 #define ID_WINDOW_SWAP 200
@@ -124,6 +126,7 @@ EVT_MENU( ID_IMPORT_XRC, MainFrame::OnImportXrc )
 EVT_MENU( ID_GENERATE_CODE, MainFrame::OnGenerateCode )
 EVT_MENU( ID_UNDO, MainFrame::OnUndo )
 EVT_MENU( ID_REDO, MainFrame::OnRedo )
+EVT_MENU( ID_HISTORY, MainFrame::OnHistory )
 EVT_MENU( ID_DELETE, MainFrame::OnDelete )
 EVT_MENU( ID_CUT, MainFrame::OnCut )
 EVT_MENU( ID_COPY, MainFrame::OnCopy )
@@ -153,6 +156,7 @@ EVT_MENU( ID_WINDOW_SWAP, MainFrame::OnWindowSwap )
 
 EVT_UPDATE_UI( ID_CLIPBOARD_PASTE, MainFrame::OnClipboardPasteUpdateUI )
 EVT_CLOSE( MainFrame::OnClose )
+EVT_ACTIVATE( MainFrame::OnActivate )
 
 EVT_FB_CODE_GENERATION( MainFrame::OnCodeGeneration )
 EVT_FB_OBJECT_CREATED( MainFrame::OnObjectCreated )
@@ -216,6 +220,9 @@ m_style( style ),
 m_page_selection( 0 ),
 m_rightSplitter_sash_pos( 300 ),
 m_autoSash( false ), // autosash function is temporarily disabled due to possible bug(?) in wxMSW event system (workaround is needed)
+m_frameStateValid( false ),
+m_updateFramePending( false ),
+m_menuEdit( NULL ),
 m_findData( wxFR_DOWN ),
 m_findDialog( NULL )
 {
@@ -248,6 +255,12 @@ m_findDialog( NULL )
 	SetStatusWidths( sizeof( widths ) / sizeof( int ), widths );
 	CreateFBToolBar();
 
+	ObjectDatabase::IconStats iconStats = AppData()->GetObjectDatabase()->GetIconStats();
+	if ( iconStats.icons > 0 )
+	{
+		m_startupStatus = wxString::Format( wxT( " Component icons loaded in %ld ms, %u of %u from the icon cache." ), iconStats.milliseconds, iconStats.fromCache, iconStats.icons );
+	}
+
 	/////////////////////////////////////////////////////////////////////////////
 	// Create the gui
 	/////////////////////////////////////////////////////////////////////////////
@@ -693,13 +706,19 @@ void MainFrame::OnClose( wxCloseEvent &event )
 		return;
 
 	SavePosition( wxT( "mainframe" ) );
+
+	unsigned long bitmapHits, bitmapMisses;
+	AppBitmaps::GetCacheStats( &bitmapHits, &bitmapMisses );
+	LogDebug( wxT( "Application bitmaps: %lu from the cache, %lu loaded or scaled" ), bitmapHits, bitmapMisses );
+
     m_rightSplitter->Disconnect( wxEVT_COMMAND_SPLITTER_SASH_POS_CHANGED, wxSplitterEventHandler( MainFrame::OnSplitterChanged ) );
 	event.Skip();
 }
 
 void MainFrame::OnProjectLoaded( wxFBEvent& )
 {
-	GetStatusBar()->SetStatusText( wxT( "Project Loaded!" ) );
+	GetStatusBar()->SetStatusText( wxT( "Project Loaded!" ) + m_startupStatus );
+	m_startupStatus.clear();
 	PObjectBase project = AppData()->GetProjectData();
 
 	if ( project )
@@ -902,125 +921,220 @@ void MainFrame::OnProjectRefresh( wxFBEvent& )
 void MainFrame::OnUndo( wxCommandEvent &)
 {
 	AppData()->Undo();
+	GetStatusBar()->SetStatusText( AppData()->GetHistoryReport() );
 }
 
 void MainFrame::OnRedo( wxCommandEvent &)
 {
 	AppData()->Redo();
+	GetStatusBar()->SetStatusText( AppData()->GetHistoryReport() );
 }
 
-void MainFrame::UpdateLayoutTools()
+void MainFrame::OnHistory( wxCommandEvent &)
 {
-	int option = -1;
-	int border = 0;
-	int flag = 0;
-	int orient = 0;
+	// Position 0 is the state before the first step, position n the state after step n
+	wxArrayString steps;
+	steps.Add( _("Initial state") );
+	for ( size_t i = 0; i < AppData()->GetHistoryCount(); ++i )
+	{
+		steps.Add( AppData()->GetHistoryDescription( i ) );
+	}
 
-	bool gotLayoutSettings = AppData()->GetLayoutSettings( AppData()->GetSelectedObject(), &flag, &option, &border, &orient );
-	wxToolBar* toolbar = GetToolBar();
-	wxMenu* menuEdit = GetMenuBar()->GetMenu( GetMenuBar()->FindMenu( wxT( "Edit" ) ) );
-
-	// Enable the layout tools if there are layout settings, else disable the tools
-	menuEdit->Enable( ID_EXPAND, gotLayoutSettings );
-	toolbar->EnableTool( ID_EXPAND, gotLayoutSettings );
-	menuEdit->Enable( ID_STRETCH, option >= 0 );
-	toolbar->EnableTool( ID_STRETCH, option >= 0 );
-
-	bool enableHorizontalTools = ( orient != wxHORIZONTAL ) && gotLayoutSettings;
-	menuEdit->Enable( ID_ALIGN_LEFT, enableHorizontalTools );
-	toolbar->EnableTool( ID_ALIGN_LEFT, enableHorizontalTools );
-	menuEdit->Enable( ID_ALIGN_CENTER_H, enableHorizontalTools );
-	toolbar->EnableTool( ID_ALIGN_CENTER_H, enableHorizontalTools );
-	menuEdit->Enable( ID_ALIGN_RIGHT, enableHorizontalTools );
-	toolbar->EnableTool( ID_ALIGN_RIGHT, enableHorizontalTools );
-
-	bool enableVerticalTools = ( orient != wxVERTICAL ) && gotLayoutSettings;
-	menuEdit->Enable( ID_ALIGN_TOP, enableVerticalTools );
-	toolbar->EnableTool( ID_ALIGN_TOP, enableVerticalTools );
-	menuEdit->Enable( ID_ALIGN_CENTER_V, enableVerticalTools );
-	toolbar->EnableTool( ID_ALIGN_CENTER_V, enableVerticalTools );
-	menuEdit->Enable( ID_ALIGN_BOTTOM, enableVerticalTools );
-	toolbar->EnableTool( ID_ALIGN_BOTTOM, enableVerticalTools );
-
-	toolbar->EnableTool( ID_BORDER_TOP, gotLayoutSettings );
-	toolbar->EnableTool( ID_BORDER_RIGHT, gotLayoutSettings );
-	toolbar->EnableTool( ID_BORDER_LEFT, gotLayoutSettings );
-	toolbar->EnableTool( ID_BORDER_BOTTOM, gotLayoutSettings );
-
-	// Toggle the toolbar buttons according to the properties, if there are layout settings
-	toolbar->ToggleTool( ID_EXPAND,         ( ( flag & wxEXPAND ) != 0 ) && gotLayoutSettings );
-	toolbar->ToggleTool( ID_STRETCH,        ( option > 0 ) && gotLayoutSettings );
-	toolbar->ToggleTool( ID_ALIGN_LEFT,     !( ( flag & ( wxALIGN_RIGHT | wxALIGN_CENTER_HORIZONTAL ) ) != 0 ) && enableHorizontalTools );
-	toolbar->ToggleTool( ID_ALIGN_CENTER_H, ( ( flag & wxALIGN_CENTER_HORIZONTAL ) != 0 ) && enableHorizontalTools );
-	toolbar->ToggleTool( ID_ALIGN_RIGHT,    ( ( flag & wxALIGN_RIGHT ) != 0 ) && enableHorizontalTools );
-	toolbar->ToggleTool( ID_ALIGN_TOP,      !( ( flag & ( wxALIGN_BOTTOM | wxALIGN_CENTER_VERTICAL ) ) != 0 ) && enableVerticalTools );
-	toolbar->ToggleTool( ID_ALIGN_CENTER_V, ( ( flag & wxALIGN_CENTER_VERTICAL ) != 0 ) && enableVerticalTools );
-	toolbar->ToggleTool( ID_ALIGN_BOTTOM,   ( ( flag & wxALIGN_BOTTOM ) != 0 ) && enableVerticalTools );
-
-	toolbar->ToggleTool( ID_BORDER_TOP,      ( ( flag & wxTOP ) != 0 ) && gotLayoutSettings );
-	toolbar->ToggleTool( ID_BORDER_RIGHT,    ( ( flag & wxRIGHT ) != 0 ) && gotLayoutSettings );
-	toolbar->ToggleTool( ID_BORDER_LEFT,     ( ( flag & wxLEFT ) != 0 ) && gotLayoutSettings );
-	toolbar->ToggleTool( ID_BORDER_BOTTOM,   ( ( flag & wxBOTTOM ) != 0 ) && gotLayoutSettings );
-}
-
-void MainFrame::UpdateFrame()
-{
-	// Build the title
-	wxString filename = AppData()->GetProjectFileName();
-	wxString file;
+	wxSingleChoiceDialog dialog( this, _("Choose the step to go back or forward to:"), _("Undo History"), steps );
+	dialog.SetSelection( (int)AppData()->GetHistoryPosition() );
+	if ( dialog.ShowModal() != wxID_OK )
+	{
+		return;
+	}
 
-	if ( filename.empty() )
+	AppData()->GoToHistory( (size_t)dialog.GetSelection() );
+	GetStatusBar()->SetStatusText( AppData()->GetHistoryReport() );
+}
+
+void MainFrame::UpdateFrame( bool force )
+{
+	if ( force )
 	{
-		file = wxT("untitled");
+		m_frameStateValid = false;
 	}
-	else
+
+	// Several events usually arrive for a single change, update once when all of them are processed
+	if ( !m_updateFramePending )
 	{
-		wxFileName fn( filename );
-		file = fn.GetName();
+		m_updateFramePending = true;
+		Connect( wxEVT_IDLE, wxIdleEventHandler( MainFrame::OnUpdateFrameIdle ) );
 	}
+}
+
+void MainFrame::OnUpdateFrameIdle( wxIdleEvent& event )
+{
+	Disconnect( wxEVT_IDLE, wxIdleEventHandler( MainFrame::OnUpdateFrameIdle ) );
+	m_updateFramePending = false;
+
+	FrameState state;
+	GetFrameState( &state );
+	ApplyFrameState( state );
+
+	event.Skip();
+}
+
+void MainFrame::GetFrameState( FrameState* state )
+{
+	state->file = AppData()->GetProjectFileName();
+	state->modified = AppData()->IsModified();
+	state->undo = AppData()->CanUndo();
+	state->redo = AppData()->CanRedo();
+	state->copy = AppData()->CanCopyObject();
 
-	SetTitle( wxString::Format( wxT("%s%s - wxFormBuilder v3.5 - RC2"), AppData()->IsModified() ? wxT("*") : wxT(""), file.c_str() ) );
-	GetStatusBar()->SetStatusText( filename, STATUS_FIELD_PATH );
+	int selection = m_notebook->GetSelection();
+	state->isEditor = ( selection >= 0 && m_notebook->GetPage( selection ) != m_visualEdit );
+
+	state->paste = AppData()->CanPasteObject();
+	state->clipboardPaste = AppData()->CanPasteObjectFromClipboard();
+
+	state->option = -1;
+	state->flag = 0;
+	state->orient = 0;
+	int border = 0;
+	state->layout = AppData()->GetLayoutSettings( AppData()->GetSelectedObject(), &state->flag, &state->option, &border, &state->orient );
+}
+
+void MainFrame::ApplyFrameState( const FrameState& state )
+{
+	const FrameState& old = m_frameState;
+	bool all = !m_frameStateValid;
+
+	if ( all || state.file != old.file || state.modified != old.modified )
+	{
+		// Build the title
+		wxString file;
+		if ( state.file.empty() )
+		{
+			file = wxT("untitled");
+		}
+		else
+		{
+			wxFileName fn( state.file );
+			file = fn.GetName();
+		}
+
+		SetTitle( wxString::Format( wxT("%s%s - wxFormBuilder v3.5 - RC2"), state.modified ? wxT("*") : wxT(""), file.c_str() ) );
+		GetStatusBar()->SetStatusText( state.file, STATUS_FIELD_PATH );
+	}
 
 	// Enable/Disable toolbar and menu entries
-	wxMenu* menuEdit = GetMenuBar()->GetMenu( GetMenuBar()->FindMenu( wxT( "Edit" ) ) );
+	if ( NULL == m_menuEdit )
+	{
+		m_menuEdit = GetMenuBar()->GetMenu( GetMenuBar()->FindMenu( wxT( "Edit" ) ) );
+	}
+	wxMenu* menuEdit = m_menuEdit;
 	wxToolBar* toolbar = GetToolBar();
 
-	bool redo = AppData()->CanRedo();
-	menuEdit->Enable( ID_REDO, redo );
-	toolbar->EnableTool( ID_REDO, redo );
+	if ( all || state.redo != old.redo )
+	{
+		menuEdit->Enable( ID_REDO, state.redo );
+		toolbar->EnableTool( ID_REDO, state.redo );
+	}
+
+	if ( all || state.undo != old.undo )
+	{
+		menuEdit->Enable( ID_UNDO, state.undo );
+		toolbar->EnableTool( ID_UNDO, state.undo );
+	}
 
-	bool undo = AppData()->CanUndo();
-	menuEdit->Enable( ID_UNDO, undo );
-	toolbar->EnableTool( ID_UNDO, undo );
+	if ( all || state.undo != old.undo || state.redo != old.redo )
+	{
+		menuEdit->Enable( ID_HISTORY, state.undo || state.redo );
+	}
+
+	if ( all || state.isEditor != old.isEditor )
+	{
+		menuEdit->Enable( ID_FIND, state.isEditor );
+	}
 
-	bool copy = AppData()->CanCopyObject();
-	bool isEditor = ( _("Designer") != m_notebook->GetPageText( m_notebook->GetSelection() ) );
-	menuEdit->Enable( ID_FIND, isEditor );
+	if ( all || state.copy != old.copy || state.isEditor != old.isEditor )
+	{
+		bool copy = state.copy;
+		menuEdit->Enable( ID_CLIPBOARD_COPY, copy );
 
-	menuEdit->Enable( ID_CLIPBOARD_COPY, copy );
+		menuEdit->Enable( ID_COPY, copy || state.isEditor );
+		toolbar->EnableTool( ID_COPY, copy || state.isEditor );
 
-	menuEdit->Enable( ID_COPY, copy || isEditor );
-	toolbar->EnableTool( ID_COPY, copy || isEditor );
+		menuEdit->Enable( ID_CUT, copy );
+		toolbar->EnableTool( ID_CUT, copy );
 
-	menuEdit->Enable( ID_CUT, copy );
-	toolbar->EnableTool( ID_CUT, copy );
+		menuEdit->Enable( ID_DELETE, copy );
+		toolbar->EnableTool( ID_DELETE, copy );
 
-	menuEdit->Enable( ID_DELETE, copy );
-	toolbar->EnableTool( ID_DELETE, copy );
+		menuEdit->Enable( ID_MOVE_UP, copy );
+		menuEdit->Enable( ID_MOVE_DOWN, copy );
+		menuEdit->Enable( ID_MOVE_LEFT, copy );
+		menuEdit->Enable( ID_MOVE_RIGHT, copy );
+	}
 
-	menuEdit->Enable( ID_MOVE_UP, copy );
-	menuEdit->Enable( ID_MOVE_DOWN, copy );
-	menuEdit->Enable( ID_MOVE_LEFT, copy );
-	menuEdit->Enable( ID_MOVE_RIGHT, copy );
+	if ( all || state.paste != old.paste )
+	{
+		menuEdit->Enable( ID_PASTE, state.paste );
+		toolbar->EnableTool( ID_PASTE, state.paste );
+	}
 
-	bool paste = AppData()->CanPasteObject();
-	menuEdit->Enable( ID_PASTE, paste );
-	toolbar->EnableTool( ID_PASTE, paste );
+	if ( all || state.clipboardPaste != old.clipboardPaste )
+	{
+		menuEdit->Enable( ID_CLIPBOARD_PASTE, state.clipboardPaste );
+	}
 
-	menuEdit->Enable( ID_CLIPBOARD_PASTE, AppData()->CanPasteObjectFromClipboard() );
+	if ( all || state.layout != old.layout || state.flag != old.flag || state.option != old.option || state.orient != old.orient )
+	{
+		bool gotLayoutSettings = state.layout;
+		int flag = state.flag;
+		int option = state.option;
+		int orient = state.orient;
+
+		// Enable the layout tools if there are layout settings, else disable the tools
+		menuEdit->Enable( ID_EXPAND, gotLayoutSettings );
+		toolbar->EnableTool( ID_EXPAND, gotLayoutSettings );
+		menuEdit->Enable( ID_STRETCH, option >= 0 );
+		toolbar->EnableTool( ID_STRETCH, option >= 0 );
+
+		bool enableHorizontalTools = ( orient != wxHORIZONTAL ) && gotLayoutSettings;
+		menuEdit->Enable( ID_ALIGN_LEFT, enableHorizontalTools );
+		toolbar->EnableTool( ID_ALIGN_LEFT, enableHorizontalTools );
+		menuEdit->Enable( ID_ALIGN_CENTER_H, enableHorizontalTools );
+		toolbar->EnableTool( ID_ALIGN_CENTER_H, enableHorizontalTools );
+		menuEdit->Enable( ID_ALIGN_RIGHT, enableHorizontalTools );
+		toolbar->EnableTool( ID_ALIGN_RIGHT, enableHorizontalTools );
+
+		bool enableVerticalTools = ( orient != wxVERTICAL ) && gotLayoutSettings;
+		menuEdit->Enable( ID_ALIGN_TOP, enableVerticalTools );
+		toolbar->EnableTool( ID_ALIGN_TOP, enableVerticalTools );
+		menuEdit->Enable( ID_ALIGN_CENTER_V, enableVerticalTools );
+		toolbar->EnableTool( ID_ALIGN_CENTER_V, enableVerticalTools );
+		menuEdit->Enable( ID_ALIGN_BOTTOM, enableVerticalTools );
+		toolbar->EnableTool( ID_ALIGN_BOTTOM, enableVerticalTools );
+
+		toolbar->EnableTool( ID_BORDER_TOP, gotLayoutSettings );
+		toolbar->EnableTool( ID_BORDER_RIGHT, gotLayoutSettings );
+		toolbar->EnableTool( ID_BORDER_LEFT, gotLayoutSettings );
+		toolbar->EnableTool( ID_BORDER_BOTTOM, gotLayoutSettings );
+
+		// Toggle the toolbar buttons according to the properties, if there are layout settings
+		toolbar->ToggleTool( ID_EXPAND,         ( ( flag & wxEXPAND ) != 0 ) && gotLayoutSettings );
+		toolbar->ToggleTool( ID_STRETCH,        ( option > 0 ) && gotLayoutSettings );
+		toolbar->ToggleTool( ID_ALIGN_LEFT,     !( ( flag & ( wxALIGN_RIGHT | wxALIGN_CENTER_HORIZONTAL ) ) != 0 ) && enableHorizontalTools );
+		toolbar->ToggleTool( ID_ALIGN_CENTER_H, ( ( flag & wxALIGN_CENTER_HORIZONTAL ) != 0 ) && enableHorizontalTools );
+		toolbar->ToggleTool( ID_ALIGN_RIGHT,    ( ( flag & wxALIGN_RIGHT ) != 0 ) && enableHorizontalTools );
+		toolbar->ToggleTool( ID_ALIGN_TOP,      !( ( flag & ( wxALIGN_BOTTOM | wxALIGN_CENTER_VERTICAL ) ) != 0 ) && enableVerticalTools );
+		toolbar->ToggleTool( ID_ALIGN_CENTER_V, ( ( flag & wxALIGN_CENTER_VERTICAL ) != 0 ) && enableVerticalTools );
+		toolbar->ToggleTool( ID_ALIGN_BOTTOM,   ( ( flag & wxALIGN_BOTTOM ) != 0 ) && enableVerticalTools );
+
+		toolbar->ToggleTool( ID_BORDER_TOP,      ( ( flag & wxTOP ) != 0 ) && gotLayoutSettings );
+		toolbar->ToggleTool( ID_BORDER_RIGHT,    ( ( flag & wxRIGHT ) != 0 ) && gotLayoutSettings );
+		toolbar->ToggleTool( ID_BORDER_LEFT,     ( ( flag & wxLEFT ) != 0 ) && gotLayoutSettings );
+		toolbar->ToggleTool( ID_BORDER_BOTTOM,   ( ( flag & wxBOTTOM ) != 0 ) && gotLayoutSettings );
+	}
 
-	UpdateLayoutTools();
+	m_frameState = state;
+	m_frameStateValid = true;
 }
 
 void MainFrame::UpdateRecentProjects()
@@ -1176,6 +1290,16 @@ void MainFrame::OnClipboardPasteUpdateUI( wxUpdateUIEvent& e )
 	e.Enable( AppData()->CanPasteObjectFromClipboard() );
 }
 
+void MainFrame::OnActivate( wxActivateEvent& event )
+{
+	// Another application may have changed the clipboard while wxFormBuilder was in the background
+	if ( event.GetActive() )
+	{
+		AppData()->InvalidateClipboardCache();
+	}
+	event.Skip();
+}
+
 void MainFrame::OnToggleExpand ( wxCommandEvent &)
 {
 	AppData()->ToggleExpandLayout( AppData()->GetSelectedObject() );
@@ -1239,7 +1363,8 @@ void MainFrame::OnChangeAlignment ( wxCommandEvent &event )
 
 	AppData()->ChangeAlignment( AppData()->GetSelectedObject(), align, vertical );
 
-	UpdateLayoutTools();
+	// The toolbar toggled the tool itself, set it again even if the state did not change
+	UpdateFrame( true );
 }
 
 void MainFrame::OnChangeBorder( wxCommandEvent& e )
@@ -1271,7 +1396,8 @@ void MainFrame::OnChangeBorder( wxCommandEvent& e )
 
 	AppData()->ToggleBorderFlag( AppData()->GetSelectedObject(), border );
 
-	UpdateLayoutTools();
+	// The toolbar toggled the tool itself, set it again even if the state did not change
+	UpdateFrame( true );
 }
 
 void MainFrame::OnXrcPreview( wxCommandEvent& WXUNUSED( e ) )
@@ -1536,6 +1662,7 @@ wxMenuBar * MainFrame::CreateFBMenuBar()
 	wxMenu *menuEdit = new wxMenu;
 	menuEdit->Append( ID_UNDO, wxT( "&Undo \tCtrl+Z" ), wxT( "Undo changes" ) );
 	menuEdit->Append( ID_REDO, wxT( "&Redo \tCtrl+Y" ), wxT( "Redo changes" ) );
+	menuEdit->Append( ID_HISTORY, wxT( "&History..." ), wxT( "Go back or forward to any step of the undo history" ) );
 	menuEdit->AppendSeparator();
 	menuEdit->Append( ID_COPY, wxT( "&Copy \tCtrl+C" ), wxT( "Copy selected object" ) );
 	menuEdit->Append( ID_CUT, wxT( "Cut \tCtrl+X" ), wxT( "Cut selected object" ) );
@@ -1794,7 +1921,7 @@ void MainFrame::CreateClassicGui()
 	SetMinSize( wxSize( 700, 465 ) );
 }
 
-void MainFrame::OnIdle( wxIdleEvent& )
+void MainFrame::OnIdle( wxIdleEvent& event )
 {
 	if ( m_leftSplitter )
 	{
@@ -1808,6 +1935,9 @@ void MainFrame::OnIdle( wxIdleEvent& )
 
 	Disconnect( wxEVT_IDLE, wxIdleEventHandler( MainFrame::OnIdle ) );
 
+	// Let the other idle handlers, like the one updating the frame, run too
+	event.Skip();
+
 	if ( m_autoSash )
 	{
 		// Init. m_rightSplitter_sash_pos
@@ -105,12 +105,47 @@ class MainFrame : public wxFrame
   wxString m_currentDir;
   wxString m_recentProjects[4];
 
-  void UpdateFrame();
+  /**
+   * State shown by the title, the status bar, the Edit menu and the toolbar.
+   * Only what differs from the last applied state is updated.
+   */
+  struct FrameState
+  {
+    wxString file;
+    bool modified;
+    bool undo;
+    bool redo;
+    bool copy;
+    bool isEditor;
+    bool paste;
+    bool clipboardPaste;
+    bool layout;   // the selected object has layout settings
+    int flag;
+    int option;
+    int orient;
+  };
+
+  FrameState m_frameState;
+  bool m_frameStateValid;   // false until the first state is applied
+  bool m_updateFramePending;
+  wxMenu* m_menuEdit;
+
+  // Shown with the first project loaded, as the status bar is not visible before
+  wxString m_startupStatus;
+
+  /**
+   * Requests an update of the frame, done once in the next idle event
+   * however many times it is requested.
+   * @param force Update every widget, not only the ones whose state changed.
+   */
+  void UpdateFrame( bool force = false );
+  void OnUpdateFrameIdle( wxIdleEvent& event );
+  void GetFrameState( FrameState* state );
+  void ApplyFrameState( const FrameState& state );
 
   // Actualiza los projectos más recientes en el menu
   void UpdateRecentProjects();
   void OnOpenRecent(wxCommandEvent &event);
-  void UpdateLayoutTools();
 
   // Used to correctly restore splitter position
   void OnIdle( wxIdleEvent& );
@@ -138,6 +173,7 @@ class MainFrame : public wxFrame
   void OnImportXrc(wxCommandEvent &event);
   void OnUndo(wxCommandEvent &event);
   void OnRedo(wxCommandEvent &event);
+  void OnHistory(wxCommandEvent &event);
   void OnCopy (wxCommandEvent &event);
   void OnPaste (wxCommandEvent &event);
   void OnCut (wxCommandEvent &event);
@@ -145,6 +181,7 @@ class MainFrame : public wxFrame
   void OnClipboardCopy(wxCommandEvent& e);
   void OnClipboardPaste(wxCommandEvent& e);
   void OnClipboardPasteUpdateUI( wxUpdateUIEvent& e );
+  void OnActivate( wxActivateEvent& event );
   void OnToggleExpand (wxCommandEvent &event);
   void OnToggleStretch (wxCommandEvent &event);
   void OnMoveUp (wxCommandEvent &event);
@@ -30,6 +30,7 @@
 #include <wx/image.h>
 #include "rad/menueditor.h"
 #include "utils/typeconv.h"
+#include "utils/trace.h"
 #include "rad/wxfbevent.h"
 #include <rad/appdata.h>
 #include "model/objectbase.h"
@@ -123,6 +124,8 @@ PObjectBase ObjectTree::GetObjectFromTreeItem( wxTreeItemId item )
 
 void ObjectTree::RebuildTree()
 {
+	TRACE_SCOPE( "designer", "ObjectTree::RebuildTree" );
+
 	m_tcObjects->Freeze();
 
 	Disconnect( wxID_ANY, wxEVT_COMMAND_TREE_ITEM_EXPANDED, wxTreeEventHandler( ObjectTree::OnExpansionChange ) );
@@ -85,7 +85,7 @@ void wxFbPalette::PopulateToolbar( PObjectPackage pkg, wxToolBar *toolbar )
 		{
 			toolbar->AddSeparator();
 		}
-		if ( NULL == info->GetComponent() )
+		if ( !info->HasComponent() )
 		{
 #if wxVERSION_NUMBER < 2900
 			LogDebug( _( "Missing Component for Class \"%s\" of Package \"%s\"." ), info->GetClassName().c_str(), pkg->GetPackageName().c_str() );
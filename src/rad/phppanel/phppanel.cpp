@@ -34,16 +34,18 @@
 #include "utils/wxfbdefs.h"
 
 #include "utils/typeconv.h"
-#include "utils/encodingutils.h"
 #include "utils/wxfbexception.h"
+#include "utils/trace.h"
 
 #include "model/objectbase.h"
 
 #include "codegen/codewriter.h"
+#include "codegen/projectcg.h"
 #include "codegen/phpcg.h"
 
 #include <wx/fdrepdlg.h>
 #include <wx/config.h>
+#include <wx/stopwatch.h>
 
 #if wxVERSION_NUMBER < 2900
     #include <wx/wxScintilla/wxscintilla.h>
@@ -192,7 +194,7 @@ void PHPPanel::OnEventHandlerModified( wxFBEventHandlerEvent& event )
 
 void PHPPanel::OnCodeGeneration( wxFBEvent& event )
 {
-    PObjectBase objectToGenerate;
+	TRACE_SCOPE( "panels", "PHPPanel::OnCodeGeneration" );
 
 	// Generate code in the panel if the panel is active
 	bool doPanel = IsShown();
@@ -206,43 +208,15 @@ void PHPPanel::OnCodeGeneration( wxFBEvent& event )
 		return;
 	}
 
-	// For code preview generate only code relevant to selected form,
-	// otherwise generate full project code.
-
-	// Create copy of the original project due to possible temporary modifications
-	PObjectBase project = PObjectBase(new ObjectBase(*AppData()->GetProjectData()));
-
-	if(panelOnly)
-	{
-	    objectToGenerate = AppData()->GetSelectedForm();
-	}
-
-	if(!panelOnly || !objectToGenerate)
-	{
-	    objectToGenerate = project;
-	}
-
-	// If only one project item should be generated then remove the rest items
-	// from the temporary project
-	if(doPanel && panelOnly && (objectToGenerate != project))
+	// The copy of the project and its analysis are shared with the other code
+	// panels handling the same event
+	std::shared_ptr< CodeGenerationProject > shared = CodeGenerationProject::FromEvent( event );
+	PObjectBase project = shared->GetProject();
+	if ( !project )
 	{
-	    if( project->GetChildCount() > 0)
-	    {
-	        unsigned int i = 0;
-            while( project->GetChildCount() > 1 )
-            {
-                if(project->GetChild( i ) != objectToGenerate)
-                {
-                    project->RemoveChild( i );
-                }
-                else
-                    i++;
-            }
-	    }
+		return;
 	}
 
-    if(!project || !objectToGenerate)return;
-
     // Get PHP properties from the project
 
 	// If PHP generation is not enabled, do not generate the file
@@ -267,18 +241,6 @@ void PHPPanel::OnCodeGeneration( wxFBEvent& event )
 		firstID = pFirstID->GetValueAsInteger();
 	}
 
-	// Get the file name
-	wxString file;
-	PProperty pfile = project->GetProperty( wxT( "file" ) );
-	if ( pfile )
-	{
-		file = pfile->GetValue();
-	}
-	if ( file.empty() )
-	{
-		file = wxT("noname");
-	}
-
 	// Determine if the path is absolute or relative
 	bool useRelativePath = false;
 	PProperty pRelPath = project->GetProperty( wxT( "relative_path" ) );
@@ -307,6 +269,7 @@ void PHPPanel::OnCodeGeneration( wxFBEvent& event )
 	if ( doPanel )
 	{
 		PHPCodeGenerator codegen;
+		codegen.SetAnalysis( shared->GetAnalysis() );
 		codegen.UseRelativePath( useRelativePath, path );
 
 		if ( pFirstID )
@@ -327,7 +290,9 @@ void PHPPanel::OnCodeGeneration( wxFBEvent& event )
 		int phpLine = phpEditor->GetFirstVisibleLine() + phpEditor->LinesOnScreen() - 1;
 		int phpXOffset = phpEditor->GetXOffset();
 
+		wxStopWatch watch;
 		codegen.GenerateCode( project );
+		shared->AddTime( wxT("PHP preview"), watch.Time() );
 
 		phpEditor->SetReadOnly( true );
 		phpEditor->GotoLine( phpLine );
@@ -341,50 +306,10 @@ void PHPPanel::OnCodeGeneration( wxFBEvent& event )
 	// Generate code in the file
 	if ( doFile )
 	{
-		try
-		{
-			PHPCodeGenerator codegen;
-			codegen.UseRelativePath( useRelativePath, path );
-
-			if ( pFirstID )
-			{
-				codegen.SetFirstID( firstID );
-			}
-
-			// Determin if Microsoft BOM should be used
-			bool useMicrosoftBOM = false;
-
-			PProperty pUseMicrosoftBOM = project->GetProperty( wxT( "use_microsoft_bom" ) );
-
-			if ( pUseMicrosoftBOM )
-			{
-				useMicrosoftBOM = ( pUseMicrosoftBOM->GetValueAsInteger() != 0 );
-			}
-
-			// Determine if Utf8 or Ansi is to be created
-			bool useUtf8 = false;
-			PProperty pUseUtf8 = project->GetProperty( _("encoding") );
-
-			if ( pUseUtf8 )
-			{
-				useUtf8 = ( pUseUtf8->GetValueAsString() != wxT("ANSI") );
-			}
-
-			PCodeWriter php_cw( new FileCodeWriter( path + file + wxT( ".php" ), useMicrosoftBOM, useUtf8 ) );
-
-			codegen.SetSourceWriter( php_cw );
-			codegen.GenerateCode( project );
-			wxLogStatus( wxT( "Code generated on \'%s\'." ), path.c_str() );
-
-			// check if we have to convert to ANSI encoding
-			if (project->GetPropertyAsString(wxT("encoding")) == wxT("ANSI"))
-			{
-				UTF8ToAnsi(path + file + wxT( ".php" ));
-			}
-		}
-		catch ( wxFBException& ex )
-		{
-			wxLogError( ex.what() );
-		}
+		wxStopWatch watch;
+		ProjectCodeGenerator codegen( project, path );
+		codegen.SetAnalysis( shared->GetAnalysis() );
+		codegen.GenerateCode( wxT("PHP") );
+		shared->AddTime( wxT("PHP files"), watch.Time() );
 	}
 }
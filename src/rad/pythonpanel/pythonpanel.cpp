@@ -34,16 +34,18 @@
 #include "utils/wxfbdefs.h"
 
 #include "utils/typeconv.h"
-#include "utils/encodingutils.h"
 #include "utils/wxfbexception.h"
+#include "utils/trace.h"
 
 #include "model/objectbase.h"
 
 #include "codegen/codewriter.h"
+#include "codegen/projectcg.h"
 #include "codegen/pythoncg.h"
 
 #include <wx/fdrepdlg.h>
 #include <wx/config.h>
+#include <wx/stopwatch.h>
 
 #if wxVERSION_NUMBER < 2900
     #include <wx/wxScintilla/wxscintilla.h>
@@ -185,7 +187,7 @@ void PythonPanel::OnEventHandlerModified( wxFBEventHandlerEvent& event )
 
 void PythonPanel::OnCodeGeneration( wxFBEvent& event )
 {
-    PObjectBase objectToGenerate;
+	TRACE_SCOPE( "panels", "PythonPanel::OnCodeGeneration" );
 
 	// Generate code in the panel if the panel is active
 	bool doPanel = IsShown();
@@ -199,43 +201,15 @@ void PythonPanel::OnCodeGeneration( wxFBEvent& event )
 		return;
 	}
 
-	// For code preview generate only code relevant to selected form,
-	// otherwise generate full project code.
-
-	// Create copy of the original project due to possible temporary modifications
-	PObjectBase project = PObjectBase(new ObjectBase(*AppData()->GetProjectData()));
-
-	if(panelOnly)
-	{
-	    objectToGenerate = AppData()->GetSelectedForm();
-	}
-
-	if(!panelOnly || !objectToGenerate)
-	{
-	    objectToGenerate = project;
-	}
-
-	// If only one project item should be generated then remove the rest items
-	// from the temporary project
-	if(doPanel && panelOnly && (objectToGenerate != project))
+	// The copy of the project and its analysis are shared with the other code
+	// panels handling the same event
+	std::shared_ptr< CodeGenerationProject > shared = CodeGenerationProject::FromEvent( event );
+	PObjectBase project = shared->GetProject();
+	if ( !project )
 	{
-	    if( project->GetChildCount() > 0)
-	    {
-	        unsigned int i = 0;
-            while( project->GetChildCount() > 1 )
-            {
-                if(project->GetChild( i ) != objectToGenerate)
-                {
-                    project->RemoveChild( i );
-                }
-                else
-                    i++;
-            }
-	    }
+		return;
 	}
 
-    if(!project || !objectToGenerate)return;
-
     // Get Python properties from the project
 
 	// If Python generation is not enabled, do not generate the file
@@ -260,18 +234,6 @@ void PythonPanel::OnCodeGeneration( wxFBEvent& event )
 		firstID = pFirstID->GetValueAsInteger();
 	}
 
-	// Get the file name
-	wxString file;
-	PProperty pfile = project->GetProperty( wxT( "file" ) );
-	if ( pfile )
-	{
-		file = pfile->GetValue();
-	}
-	if ( file.empty() )
-	{
-		file = wxT("noname");
-	}
-
 	// Determine if the path is absolute or relative
 	bool useRelativePath = false;
 	PProperty pRelPath = project->GetProperty( wxT( "relative_path" ) );
@@ -300,6 +262,7 @@ void PythonPanel::OnCodeGeneration( wxFBEvent& event )
 	if ( doPanel )
 	{
 		PythonCodeGenerator codegen;
+		codegen.SetAnalysis( shared->GetAnalysis() );
 		codegen.UseRelativePath( useRelativePath, path );
 
 		if ( pFirstID )
@@ -320,7 +283,9 @@ void PythonPanel::OnCodeGeneration( wxFBEvent& event )
 		int pythonLine = pythonEditor->GetFirstVisibleLine() + pythonEditor->LinesOnScreen() - 1;
 		int pythonXOffset = pythonEditor->GetXOffset();
 
+		wxStopWatch watch;
 		codegen.GenerateCode( project );
+		shared->AddTime( wxT("Python preview"), watch.Time() );
 
 		pythonEditor->SetReadOnly( true );
 		pythonEditor->GotoLine( pythonLine );
@@ -334,50 +299,10 @@ void PythonPanel::OnCodeGeneration( wxFBEvent& event )
 	// Generate code in the file
 	if ( doFile )
 	{
-		try
-		{
-			PythonCodeGenerator codegen;
-			codegen.UseRelativePath( useRelativePath, path );
-
-			if ( pFirstID )
-			{
-				codegen.SetFirstID( firstID );
-			}
-
-			// Determin if Microsoft BOM should be used
-			bool useMicrosoftBOM = false;
-
-			PProperty pUseMicrosoftBOM = project->GetProperty( wxT( "use_microsoft_bom" ) );
-
-			if ( pUseMicrosoftBOM )
-			{
-				useMicrosoftBOM = ( pUseMicrosoftBOM->GetValueAsInteger() != 0 );
-			}
-
-			// Determine if Utf8 or Ansi is to be created
-			bool useUtf8 = false;
-			PProperty pUseUtf8 = project->GetProperty( _("encoding") );
-
-			if ( pUseUtf8 )
-			{
-				useUtf8 = ( pUseUtf8->GetValueAsString() != wxT("ANSI") );
-			}
-
-			PCodeWriter python_cw( new FileCodeWriter( path + file + wxT( ".py" ), useMicrosoftBOM, useUtf8 ) );
-
-			codegen.SetSourceWriter( python_cw );
-			codegen.GenerateCode( project );
-			wxLogStatus( wxT( "Code generated on \'%s\'." ), path.c_str() );
-
-			// check if we have to convert to ANSI encoding
-			if (project->GetPropertyAsString(wxT("encoding")) == wxT("ANSI"))
-			{
-				UTF8ToAnsi(path + file + wxT( ".py" ));
-			}
-		}
-		catch ( wxFBException& ex )
-		{
-			wxLogError( ex.what() );
-		}
+		wxStopWatch watch;
+		ProjectCodeGenerator codegen( project, path );
+		codegen.SetAnalysis( shared->GetAnalysis() );
+		codegen.GenerateCode( wxT("Python") );
+		shared->AddTime( wxT("Python files"), watch.Time() );
 	}
 }
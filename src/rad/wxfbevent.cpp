@@ -144,3 +144,22 @@ wxEvent* wxFBEventHandlerEvent::Clone() const
 {
 	return new wxFBEventHandlerEvent( *this );
 }
+
+wxFBCodeGenerationEvent::wxFBCodeGenerationEvent( wxEventType commandType, std::shared_ptr< CodeGenerationProject > project )
+:
+wxFBEvent( commandType ),
+m_project( project )
+{
+}
+
+wxFBCodeGenerationEvent::wxFBCodeGenerationEvent( const wxFBCodeGenerationEvent& event )
+:
+wxFBEvent( event ),
+m_project( event.m_project )
+{
+}
+
+wxEvent* wxFBCodeGenerationEvent::Clone() const
+{
+	return new wxFBCodeGenerationEvent( *this );
+}
@@ -82,6 +82,20 @@ private:
   PObjectBase m_object;
 };
 
+class CodeGenerationProject;
+
+class wxFBCodeGenerationEvent : public wxFBEvent
+{
+public:
+  wxFBCodeGenerationEvent( wxEventType commandType, std::shared_ptr< CodeGenerationProject > project );
+  wxFBCodeGenerationEvent( const wxFBCodeGenerationEvent& event );
+  wxEvent* Clone() const;
+  std::shared_ptr< CodeGenerationProject > GetProject() { return m_project; }
+
+private:
+  std::shared_ptr< CodeGenerationProject > m_project;
+};
+
 
 typedef void (wxEvtHandler::*wxFBEventFunction)        (wxFBEvent&);
 typedef void (wxEvtHandler::*wxFBPropertyEventFunction)(wxFBPropertyEvent&);
@@ -213,3 +213,15 @@ wxNoObject* wxFBManager::NewNoObject()
 {
     return new wxNoObject;
 }
+
+unsigned int wxFBManager::GetPreviewLimit()
+{
+	PObjectBase project = AppData()->GetProjectData();
+	if ( !project )
+	{
+		return 0;
+	}
+
+	int limit = project->GetPropertyAsInteger( wxT("designer_preview_limit") );
+	return ( limit > 0 ? (unsigned int)limit : 0 );
+}
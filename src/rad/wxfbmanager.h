@@ -50,6 +50,9 @@ public:
 
 	// Returns true if selection changed, false if already selected
 	bool SelectObject( wxObject* wxobject );
+
+	// Reads the "designer_preview_limit" property of the project
+	unsigned int GetPreviewLimit();
 };
 
 #endif //WXFBMANAGER
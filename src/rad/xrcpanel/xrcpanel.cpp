@@ -29,6 +29,7 @@
 
 #include "codegen/xrccg.h"
 #include "codegen/codewriter.h"
+#include "codegen/projectcg.h"
 
 #include "rad/codeeditor/codeeditor.h"
 #include "rad/bitmaps.h"
@@ -37,6 +38,7 @@
 #include "model/objectbase.h"
 #include "utils/typeconv.h"
 #include "utils/wxfbexception.h"
+#include "utils/trace.h"
 
 #include <wx/fdrepdlg.h>
 
@@ -177,6 +179,8 @@ void XrcPanel::OnObjectChange( wxFBObjectEvent& event )
 
 void XrcPanel::OnCodeGeneration( wxFBEvent& event )
 {
+	TRACE_SCOPE( "panels", "XrcPanel::OnCodeGeneration" );
+
     PObjectBase project;
 
 	// Using the previously unused Id field in the event to carry a boolean
@@ -245,40 +249,13 @@ void XrcPanel::OnCodeGeneration( wxFBEvent& event )
 	}
 
 	// And now in the file.
+	try
 	{
-		XrcCodeGenerator codegen;
-
-		wxString file, pathEntry;
-
-		wxString path;
-
-		try
-		{
-			// Get the output path
-			path = AppData()->GetOutputPath();
-
-			PProperty pfile = project->GetProperty( wxT( "file" ) );
-
-			if ( pfile )
-				file = pfile->GetValue();
-
-			if ( file.empty() )
-			{
-				file = wxT( "noname" );
-			}
-
-			wxString filePath;
-
-			filePath << path << file << wxT( ".xrc" );
-			PCodeWriter cw( new FileCodeWriter( filePath ) );
-
-			codegen.SetWriter( cw );
-			codegen.GenerateCode( project );
-			wxLogStatus( wxT( "Code generated on \'%s\'." ), path.c_str() );
-		}
-		catch ( wxFBException& ex )
-		{
-			wxLogError( ex.what() );
-		}
+		ProjectCodeGenerator codegen( project, AppData()->GetOutputPath() );
+		codegen.GenerateCode( wxT("XRC") );
+	}
+	catch ( wxFBException& ex )
+	{
+		wxLogError( ex.what() );
 	}
 }
@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "stringpool.h"
+
+#include <wx/hashmap.h>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+	struct StringHash
+	{
+		size_t operator()( const wxString* value ) const
+		{
+			return wxStringHash()( *value );
+		}
+	};
+
+	struct StringEqual
+	{
+		bool operator()( const wxString* first, const wxString* second ) const
+		{
+			return *first == *second;
+		}
+	};
+
+	// Pooled strings are spread over several maps, each one with its own lock,
+	// so threads creating objects at the same time seldom wait for each other
+	struct Shard
+	{
+		// Keyed by the pooled string itself, so the text is not stored twice
+		typedef std::unordered_map< const wxString*, std::weak_ptr< const wxString >, StringHash, StringEqual > Map;
+
+		std::mutex mutex;
+		Map strings;
+	};
+
+	// The pooled strings point to the pool, so it outlives them even when the
+	// last one is released during the destruction of the static objects.
+	struct Pool
+	{
+		static const size_t SHARDS = 16;
+
+		Shard shards[ SHARDS ];
+
+		Shard& GetShard( const wxString& value )
+		{
+			return shards[ StringHash()( &value ) % SHARDS ];
+		}
+	};
+
+	typedef std::shared_ptr< Pool > PPool;
+
+	PPool GetPool()
+	{
+		static PPool pool( new Pool );
+		return pool;
+	}
+
+	struct Release
+	{
+		PPool pool;
+		Shard* shard;
+
+		void operator()( const wxString* value ) const
+		{
+			{
+				std::lock_guard< std::mutex > lock( shard->mutex );
+
+				// Intern may already have replaced it by an equal string
+				Shard::Map::iterator it = shard->strings.find( value );
+				if ( it != shard->strings.end() && it->first == value )
+				{
+					shard->strings.erase( it );
+				}
+			}
+			delete value;
+		}
+	};
+}
+
+StringPool::PString StringPool::Intern( const wxString& value )
+{
+	PPool pool = GetPool();
+	Shard& shard = pool->GetShard( value );
+	std::lock_guard< std::mutex > lock( shard.mutex );
+
+	Shard::Map::iterator it = shard.strings.find( &value );
+	if ( it != shard.strings.end() )
+	{
+		PString pooled = it->second.lock();
+		if ( pooled )
+		{
+			return pooled;
+		}
+
+		// Released by its last holder, which is waiting to remove it
+		shard.strings.erase( it );
+	}
+
+	Release release = { pool, &shard };
+	PString pooled( new wxString( value ), release );
+	shard.strings.insert( Shard::Map::value_type( pooled.get(), pooled ) );
+	return pooled;
+}
+
+StringPool::PString StringPool::Empty()
+{
+	static PString empty = Intern( wxEmptyString );
+	return empty;
+}
+
+StringPool::Stats StringPool::GetStats()
+{
+	PPool pool = GetPool();
+
+	Stats stats = { 0, 0, 0 };
+	for ( size_t i = 0; i < Pool::SHARDS; ++i )
+	{
+		Shard& shard = pool->shards[i];
+		std::lock_guard< std::mutex > lock( shard.mutex );
+
+		for ( Shard::Map::const_iterator it = shard.strings.begin(); it != shard.strings.end(); ++it )
+		{
+			long references = it->second.use_count();
+			if ( references > 0 )
+			{
+				++stats.values;
+				stats.references += references;
+				stats.chars += it->first->length();
+			}
+		}
+	}
+	return stats;
+}
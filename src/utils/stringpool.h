@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef __STRING_POOL_H__
+#define __STRING_POOL_H__
+
+#include <wx/string.h>
+#include <memory>
+
+/**
+ * Keeps a single copy of equal strings.
+ * Most property values of a project repeat (fonts, colours, wxID_ANY, sizer
+ * flags...), the objects share the pooled copy instead of holding their own.
+ * Pooled strings are immutable, to change a value intern the new one. A string
+ * leaves the pool when nobody references it. It is safe to use from several
+ * threads.
+ */
+class StringPool
+{
+public:
+	typedef std::shared_ptr< const wxString > PString;
+
+	struct Stats
+	{
+		size_t values;      // different strings in the pool
+		size_t references;  // holders of those strings
+		size_t chars;       // characters stored by the pool
+	};
+
+	/**
+	 * Returns the pooled copy of the string, adding it if it is not pooled yet.
+	 */
+	static PString Intern( const wxString& value );
+
+	/**
+	 * The pooled empty string, which does not need a lookup.
+	 */
+	static PString Empty();
+
+	static Stats GetStats();
+};
+
+#endif //__STRING_POOL_H__
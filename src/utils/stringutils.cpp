@@ -35,6 +35,16 @@
 #include <wx/arrstr.h>
 #include <wx/filefn.h>
 
+#include <vector>
+#include <string.h>
+
+#ifdef __UNIX__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 wxString StringUtils::IntToStr(int num)
 {
   //wxString stream;
@@ -92,6 +102,165 @@ wxFontEncoding StringUtils::GetEncodingFromUser( const wxString& message )
 }
 
 
+namespace
+{
+	/**
+	 * Contents of an xml file, null terminated, with the line endings normalized
+	 * to '\n' as TinyXML expects. Where possible the file is mapped read-only and
+	 * parsed in place, so it is not copied. It is copied only when the line endings
+	 * have to change or the mapping would not be null terminated.
+	 */
+	class XMLFileData
+	{
+	private:
+		const char* m_data;
+		std::vector< char > m_copy;
+	#ifdef __UNIX__
+		void* m_map;
+		size_t m_mapSize;
+	#endif
+
+		void Copy( const char* data, size_t size )
+		{
+			// Same normalization as TiXmlDocument::LoadFile, "\r\n" and "\r" become "\n"
+			m_copy.resize( size + 1 );
+			size_t length = 0;
+			for ( size_t i = 0; i < size; ++i )
+			{
+				if ( '\r' == data[i] )
+				{
+					m_copy[ length++ ] = '\n';
+					if ( i + 1 < size && '\n' == data[ i + 1 ] )
+					{
+						++i;
+					}
+				}
+				else
+				{
+					m_copy[ length++ ] = data[i];
+				}
+			}
+			m_copy[ length ] = '\0';
+			m_data = &m_copy[0];
+		}
+
+		bool Map( const wxString& path )
+		{
+		#ifdef __UNIX__
+			int fd = open( path.fn_str(), O_RDONLY );
+			if ( fd < 0 )
+			{
+				return false;
+			}
+
+			struct stat info;
+			if ( fstat( fd, &info ) != 0 || info.st_size <= 0 )
+			{
+				close( fd );
+				return false;
+			}
+
+			size_t size = (size_t)info.st_size;
+			void* map = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+			close( fd );
+			if ( MAP_FAILED == map )
+			{
+				return false;
+			}
+
+			// The rest of the last page is filled with zeros, which terminates the string
+			const char* data = static_cast< const char* >( map );
+			if ( size % sysconf( _SC_PAGESIZE ) != 0 && NULL == memchr( data, '\r', size ) )
+			{
+				m_map = map;
+				m_mapSize = size;
+				m_data = data;
+			}
+			else
+			{
+				Copy( data, size );
+				munmap( map, size );
+			}
+			return true;
+		#else
+			return false;
+		#endif
+		}
+
+	public:
+		XMLFileData()
+		:
+		m_data( NULL )
+	#ifdef __UNIX__
+		, m_map( NULL ),
+		m_mapSize( 0 )
+	#endif
+		{
+		}
+
+		~XMLFileData()
+		{
+		#ifdef __UNIX__
+			if ( m_map != NULL )
+			{
+				munmap( m_map, m_mapSize );
+			}
+		#endif
+		}
+
+		bool Load( const wxString& path )
+		{
+			if ( Map( path ) )
+			{
+				return true;
+			}
+
+			// Not mappable (empty file, or not supported here), read it
+			wxFFile file( path, wxT("rb") );
+			if ( !file.IsOpened() )
+			{
+				return false;
+			}
+
+			wxFileOffset length = file.Length();
+			std::vector< char > buffer( length > 0 ? (size_t)length : 0 );
+			if ( !buffer.empty() && file.Read( &buffer[0], buffer.size() ) != buffer.size() )
+			{
+				return false;
+			}
+
+			Copy( buffer.empty() ? "" : &buffer[0], buffer.size() );
+			return true;
+		}
+
+		const char* GetData() const
+		{
+			return m_data;
+		}
+	};
+
+	/**
+	 * Parses the file into the document, returns false if it cannot be read or parsed.
+	 * If it cannot be read, the error of the document is TIXML_ERROR_OPENING_FILE.
+	 */
+	bool ParseXMLFile( TiXmlDocument* doc, const wxString& path )
+	{
+		doc->Clear();
+		doc->SetValue( std::string( path.mb_str( wxConvFile ) ) );
+
+		XMLFileData data;
+		if ( !data.Load( path ) )
+		{
+			// Same error as TiXmlDocument::LoadFile, so ErrorDesc() describes it
+			doc->SetError( TiXmlBase::TIXML_ERROR_OPENING_FILE, 0, 0, TIXML_ENCODING_UNKNOWN );
+			return false;
+		}
+
+		doc->Parse( data.GetData() );
+		return !doc->Error();
+	}
+}
+
 namespace XMLUtils
 {
 	template < class T, class U >
@@ -221,8 +390,15 @@ void XMLUtils::LoadXMLFile( ticpp::Document& doc, bool condenseWhiteSpace, const
 			THROW_WXFBEX( _("The file does not exist.\nFile: ") << path )
 		}
 		TiXmlBase::SetCondenseWhiteSpace( condenseWhiteSpace );
-		doc.SetValue( std::string( path.mb_str( wxConvFile ) ) );
-		doc.LoadFile();
+		if ( !ParseXMLFile( doc.GetTiXmlPointer(), path ) )
+		{
+			if ( TiXmlBase::TIXML_ERROR_OPENING_FILE == doc.GetTiXmlPointer()->ErrorId() )
+			{
+				// Converting the encoding would not help
+				THROW_WXFBEX( _("Unable to open file: ") << path )
+			}
+			throw ticpp::Exception( doc.GetTiXmlPointer()->ErrorDesc() );
+		}
 	}
 	catch ( ticpp::Exception& )
 	{
@@ -277,9 +453,14 @@ void XMLUtils::LoadXMLFile( TiXmlDocument& doc, bool condenseWhiteSpace, const w
 	}
 
 	TiXmlBase::SetCondenseWhiteSpace( condenseWhiteSpace );
-	doc.SetValue( std::string( path.mb_str( wxConvFile ) ) );
-	if ( !doc.LoadFile() )
+	if ( !ParseXMLFile( &doc, path ) )
 	{
+		if ( TiXmlBase::TIXML_ERROR_OPENING_FILE == doc.ErrorId() )
+		{
+			// Converting the encoding would not help
+			THROW_WXFBEX( _("Unable to open file: ") << path )
+		}
+
 		// Ask user to all wxFB to convert the file to UTF-8 and add the XML declaration
 		wxString msg = _("This xml file could not be loaded. This could be the result of an unsupported encoding.\n");
 		msg 		+= _("Would you like wxFormBuilder to backup the file and convert it to UTF-8\?\n");
@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "trace.h"
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+#include <wx/longlong.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct TraceEvent
+	{
+		const char* category;
+		const char* name;
+		wxString detail;
+		long long start;
+		long long duration;
+		int thread;
+	};
+
+	std::mutex s_mutex;
+	std::vector< TraceEvent > s_events;
+	std::map< std::thread::id, int > s_threads;
+	std::chrono::steady_clock::time_point s_origin;
+	wxString s_file;
+
+	wxString EscapeJson( const wxString& text )
+	{
+		wxString result;
+		result.reserve( text.length() );
+		for ( wxString::const_iterator c = text.begin(); c != text.end(); ++c )
+		{
+			wxChar ch = *c;
+			switch ( ch )
+			{
+				case wxT('"'):	result << wxT("\\\""); break;
+				case wxT('\\'):	result << wxT("\\\\"); break;
+				case wxT('\n'):	result << wxT("\\n"); break;
+				case wxT('\r'):	result << wxT("\\r"); break;
+				case wxT('\t'):	result << wxT("\\t"); break;
+				default:
+					if ( ch < 0x20 )
+					{
+						result << wxString::Format( wxT("\\u%04x"), (int)ch );
+					}
+					else
+					{
+						result << ch;
+					}
+			}
+		}
+		return result;
+	}
+}
+
+bool Tracer::s_enabled = false;
+
+void Tracer::Start( const wxString& file )
+{
+	std::lock_guard< std::mutex > lock( s_mutex );
+	s_events.clear();
+	s_threads.clear();
+
+	// The working directory may change later, on Windows
+	wxFileName path( file );
+	path.MakeAbsolute();
+	s_file = path.GetFullPath();
+
+	s_origin = std::chrono::steady_clock::now();
+	s_enabled = true;
+}
+
+long long Tracer::Now()
+{
+	return std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - s_origin ).count();
+}
+
+void Tracer::AddEvent( const char* category, const char* name, const wxString& detail, long long start, long long duration )
+{
+	std::lock_guard< std::mutex > lock( s_mutex );
+	if ( !s_enabled )
+	{
+		return;
+	}
+
+	// Small thread numbers are easier to read in the viewer than the system ids
+	std::map< std::thread::id, int >::iterator thread = s_threads.find( std::this_thread::get_id() );
+	if ( thread == s_threads.end() )
+	{
+		thread = s_threads.insert( std::make_pair( std::this_thread::get_id(), (int)s_threads.size() + 1 ) ).first;
+	}
+
+	TraceEvent event = { category, name, detail, start, duration, thread->second };
+	s_events.push_back( event );
+}
+
+bool Tracer::Stop()
+{
+	std::lock_guard< std::mutex > lock( s_mutex );
+	if ( !s_enabled )
+	{
+		return false;
+	}
+	s_enabled = false;
+
+	wxString json = wxT("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	for ( size_t i = 0; i < s_events.size(); ++i )
+	{
+		const TraceEvent& event = s_events[i];
+		if ( i > 0 )
+		{
+			json << wxT(",");
+		}
+		json << wxT("\n{\"name\":\"") << EscapeJson( wxString::FromAscii( event.name ) )
+			 << wxT("\",\"cat\":\"") << EscapeJson( wxString::FromAscii( event.category ) )
+			 << wxT("\",\"ph\":\"X\",\"ts\":") << wxLongLong( event.start ).ToString()
+			 << wxT(",\"dur\":") << wxLongLong( event.duration ).ToString()
+			 << wxT(",\"pid\":1,\"tid\":") << event.thread;
+		if ( !event.detail.empty() )
+		{
+			json << wxT(",\"args\":{\"detail\":\"") << EscapeJson( event.detail ) << wxT("\"}");
+		}
+		json << wxT("}");
+	}
+	json << wxT("\n]}\n");
+
+	s_events.clear();
+
+	wxFFile file( s_file, wxT("wb") );
+	if ( !file.IsOpened() || !file.Write( json, wxConvUTF8 ) )
+	{
+		wxLogError( _("Unable to write the trace file: %s"), s_file.c_str() );
+		return false;
+	}
+
+	return true;
+}
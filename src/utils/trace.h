@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// wxFormBuilder - A Visual Dialog Editor for wxWidgets.
+// Copyright (C) 2005 José Antonio Hurtado
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// Written by
+//   José Antonio Hurtado - joseantonio.hurtado@gmail.com
+//   Juan Antonio Ortega  - jortegalalmolda@gmail.com
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <wx/string.h>
+
+/**
+ * Records how long the main operations take, to find out where the time goes.
+ * The trace is written in the Chrome trace event format, it can be opened with
+ * chrome://tracing or Perfetto. Nothing is recorded unless a file is passed
+ * with --trace.
+ */
+class Tracer
+{
+private:
+	static bool s_enabled;
+
+public:
+	/**
+	 * Starts recording, the trace is written to file by Stop.
+	 */
+	static void Start( const wxString& file );
+
+	/**
+	 * Stops recording and writes the trace.
+	 */
+	static bool Stop();
+
+	static bool IsEnabled()
+	{
+		return s_enabled;
+	}
+
+	/**
+	 * Microseconds since Start.
+	 */
+	static long long Now();
+
+	static void AddEvent( const char* category, const char* name, const wxString& detail, long long start, long long duration );
+};
+
+/**
+ * Records the time between its construction and destruction.
+ */
+class TraceScope
+{
+private:
+	const char* m_category;
+	const char* m_name;
+	wxString m_detail;
+	long long m_start;
+
+public:
+	TraceScope( const char* category, const char* name, const wxString& detail = wxEmptyString )
+	:
+	m_category( category ),
+	m_name( name ),
+	m_detail( detail ),
+	m_start( Tracer::IsEnabled() ? Tracer::Now() : -1 )
+	{
+	}
+
+	~TraceScope()
+	{
+		if ( m_start >= 0 )
+		{
+			Tracer::AddEvent( m_category, m_name, m_detail, m_start, Tracer::Now() - m_start );
+		}
+	}
+};
+
+#define TRACE_SCOPE( category, name ) TraceScope traceScope( category, name )
+
+// The detail is only evaluated while recording
+#define TRACE_SCOPE_DETAIL( category, name, detail ) TraceScope traceScope( category, name, Tracer::IsEnabled() ? wxString( detail ) : wxString() )
+
+#endif //__TRACE_H__
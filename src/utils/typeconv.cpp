@@ -43,6 +43,11 @@
 #include <wx/artprov.h>
 #include "rad/inspector/objinspect.h"
 
+#include <condition_variable>
+#include <deque>
+#include <set>
+#include <thread>
+
 ////////////////////////////////////
 
 // Assuming that the locale is constant throughout one execution,
@@ -225,19 +230,7 @@ wxSize TypeConv::StringToSize (const wxString &val)
 
 int TypeConv::BitlistToInt (const wxString &str)
 {
-	int result = 0;
-	wxStringTokenizer tkz(str, wxT("|"));
-	while (tkz.HasMoreTokens())
-	{
-		wxString token;
-		token = tkz.GetNextToken();
-		token.Trim(true);
-		token.Trim(false);
-
-		result |= GetMacroValue(token);
-	}
-
-	return result;
+	return MacroDictionary::GetInstance()->GetBitlistValue( str );
 }
 
 wxString TypeConv::PointToString(const wxPoint &point)
@@ -369,6 +362,259 @@ wxString TypeConv::FontFamilyToString( const int family )
 	return "wxFONTFAMILY_UNKNOWN";
 }
 
+// Bitmaps decoded by StringToBitmap, shared by the designer, the palette, the inspector
+// and the plugins so that rebuilding a form does not read and decode every image again.
+// Entries are keyed by absolute path and checked against the modification time and size
+// of the file, so an image edited outside wxFormBuilder is reloaded.
+class BitmapCache
+{
+private:
+	struct Entry
+	{
+		wxDateTime modified;
+		wxULongLong size;
+		wxBitmap bitmap;
+	};
+
+	typedef std::map< wxString, Entry > EntryMap;
+	EntryMap m_entries;
+
+	static const size_t MAX_ENTRIES = 1024;
+
+public:
+	bool Find( const wxFileName& file, wxBitmap* bitmap )
+	{
+		EntryMap::iterator it = m_entries.find( file.GetFullPath() );
+		if ( it == m_entries.end() )
+		{
+			return false;
+		}
+
+		if ( it->second.modified != file.GetModificationTime() || it->second.size != file.GetSize() )
+		{
+			m_entries.erase( it );
+			return false;
+		}
+
+		*bitmap = it->second.bitmap;
+		return true;
+	}
+
+	void Add( const wxFileName& file, const wxBitmap& bitmap )
+	{
+		Add( file.GetFullPath(), file.GetModificationTime(), file.GetSize(), bitmap );
+	}
+
+	void Add( const wxString& path, const wxDateTime& modified, const wxULongLong& size, const wxBitmap& bitmap )
+	{
+		if ( m_entries.size() >= MAX_ENTRIES )
+		{
+			m_entries.clear();
+		}
+
+		Entry& entry = m_entries[ path ];
+		entry.modified = modified;
+		entry.size = size;
+		entry.bitmap = bitmap;
+	}
+
+	void Clear()
+	{
+		m_entries.clear();
+	}
+};
+
+static BitmapCache s_bitmapCache;
+
+// Decodes image files on a pool of threads for StringToBitmap, while the designer is
+// being built. The workers only use wxImage, the images are turned into bitmaps and
+// added to the cache by Update, in the GUI thread.
+class BitmapDecoder
+{
+private:
+	struct Job
+	{
+		wxString path;
+		wxDateTime modified;
+		wxULongLong size;
+		wxImage image;
+	};
+
+	std::mutex m_mutex;
+	std::condition_variable m_wakeUp;
+	std::deque< Job > m_queue;
+	std::vector< Job > m_done;
+	std::set< wxString > m_pending;   // queued or being decoded
+	std::vector< std::thread > m_workers;
+	bool m_stop;
+	bool m_enabled;                   // only accessed by the GUI thread
+	bool m_updated;                   // bitmaps added to the cache since the last batch ended
+
+	static const unsigned int MAX_WORKERS = 4;
+
+	void Work()
+	{
+		#ifndef __WXFB_DEBUG__
+		wxLogNull stopLogging;
+		#endif
+
+		std::unique_lock< std::mutex > lock( m_mutex );
+		while ( true )
+		{
+			m_wakeUp.wait( lock, [ this ]() { return m_stop || !m_queue.empty(); } );
+			if ( m_stop )
+			{
+				return;
+			}
+
+			Job job = m_queue.front();
+			m_queue.pop_front();
+
+			lock.unlock();
+			job.image.LoadFile( job.path, wxBITMAP_TYPE_ANY );
+			lock.lock();
+
+			m_done.push_back( job );
+			wxWakeUpIdle();
+		}
+	}
+
+public:
+	BitmapDecoder()
+	:
+	m_stop( false ),
+	m_enabled( false ),
+	m_updated( false )
+	{
+	}
+
+	~BitmapDecoder()
+	{
+		Stop();
+	}
+
+	bool IsEnabled() const
+	{
+		return m_enabled;
+	}
+
+	void Enable( bool enable )
+	{
+	#if wxVERSION_NUMBER < 2900
+		// wxString copies share their buffer without atomic reference counting
+		wxUnusedVar( enable );
+	#else
+		m_enabled = enable;
+	#endif
+	}
+
+	void Decode( const wxFileName& file )
+	{
+		std::lock_guard< std::mutex > lock( m_mutex );
+
+		if ( !m_pending.insert( file.GetFullPath() ).second )
+		{
+			return;
+		}
+
+		Job job;
+		job.path = file.GetFullPath();
+		job.modified = file.GetModificationTime();
+		job.size = file.GetSize();
+		m_queue.push_back( job );
+
+		unsigned int workers = std::max( 1u, std::thread::hardware_concurrency() );
+		if ( m_workers.size() < std::min( workers, (unsigned int)MAX_WORKERS ) )
+		{
+			m_workers.push_back( std::thread( &BitmapDecoder::Work, this ) );
+		}
+		m_wakeUp.notify_one();
+	}
+
+	bool Update()
+	{
+		std::vector< Job > done;
+		bool finished;
+		{
+			std::lock_guard< std::mutex > lock( m_mutex );
+			done.swap( m_done );
+			for ( std::vector< Job >::iterator job = done.begin(); job != done.end(); ++job )
+			{
+				m_pending.erase( job->path );
+			}
+			finished = m_pending.empty();
+		}
+
+		// Images that could not be decoded are cached as well, so they are not tried again
+		for ( std::vector< Job >::iterator job = done.begin(); job != done.end(); ++job )
+		{
+			s_bitmapCache.Add( job->path, job->modified, job->size, ( job->image.IsOk() ? wxBitmap( job->image ) : wxNullBitmap ) );
+			m_updated = true;
+		}
+
+		if ( !finished || !m_updated )
+		{
+			return false;
+		}
+
+		m_updated = false;
+		return true;
+	}
+
+	void Stop()
+	{
+		{
+			std::lock_guard< std::mutex > lock( m_mutex );
+			m_stop = true;
+		}
+		m_wakeUp.notify_all();
+
+		for ( std::vector< std::thread >::iterator worker = m_workers.begin(); worker != m_workers.end(); ++worker )
+		{
+			worker->join();
+		}
+
+		m_workers.clear();
+		m_queue.clear();
+		m_done.clear();
+		m_pending.clear();
+		m_stop = false;
+		m_updated = false;
+	}
+};
+
+static BitmapDecoder s_bitmapDecoder;
+
+// Shown by the designer until the image is decoded
+static wxBitmap GetPlaceholderBitmap()
+{
+	static wxBitmap placeholder;
+	if ( !placeholder.IsOk() )
+	{
+		wxImage image( 16, 16 );
+		image.InitAlpha();
+		memset( image.GetAlpha(), 0, 16 * 16 );
+		placeholder = wxBitmap( image );
+	}
+	return placeholder;
+}
+
+void TypeConv::ClearBitmapCache()
+{
+	s_bitmapDecoder.Stop();
+	s_bitmapCache.Clear();
+}
+
+void TypeConv::EnableBackgroundBitmaps( bool enable )
+{
+	s_bitmapDecoder.Enable( enable );
+}
+
+bool TypeConv::UpdateBackgroundBitmaps()
+{
+	return s_bitmapDecoder.Update();
+}
+
 wxBitmap TypeConv::StringToBitmap( const wxString& filename )
 {
 	#ifndef __WXFB_DEBUG__
@@ -423,23 +669,37 @@ wxBitmap TypeConv::StringToBitmap( const wxString& filename )
 		return AppBitmaps::GetBitmap( wxT("unknown") );
 	}
 
-	// Setup the working directory to the project path - paths should be saved in the .fbp file relative to the location
-	// of the .fbp file
-	wxFileSystem system;
-	system.ChangePathTo( AppData()->GetProjectPath(), true );
-
 	// The loader can get goofy on linux if it starts with file:, not sure why (wxGTK 2.8.7)
-	wxFSFile *fsfile = NULL;
 	wxString remainder;
-	if ( path.StartsWith( wxT("file:"), &remainder ) )
+	if ( !path.StartsWith( wxT("file:"), &remainder ) )
 	{
-		fsfile = system.OpenFile( remainder, wxFS_READ | wxFS_SEEKABLE );
+		remainder = path;
 	}
-	else
+
+	// Plain files are cached, other locations (zip:, memory:, ...) always go through the file system
+	wxFileName localFile( remainder );
+	localFile.MakeAbsolute( AppData()->GetProjectPath() );
+	bool isLocal = localFile.FileExists();
+
+	wxBitmap cached;
+	if ( isLocal && s_bitmapCache.Find( localFile, &cached ) )
+	{
+		return ( cached.IsOk() ? cached : AppBitmaps::GetBitmap( wxT("unknown") ) );
+	}
+
+	if ( isLocal && s_bitmapDecoder.IsEnabled() )
 	{
-		fsfile = system.OpenFile( path, wxFS_READ | wxFS_SEEKABLE );
+		s_bitmapDecoder.Decode( localFile );
+		return GetPlaceholderBitmap();
 	}
 
+	// Setup the working directory to the project path - paths should be saved in the .fbp file relative to the location
+	// of the .fbp file
+	wxFileSystem system;
+	system.ChangePathTo( AppData()->GetProjectPath(), true );
+
+	wxFSFile *fsfile = system.OpenFile( remainder, wxFS_READ | wxFS_SEEKABLE );
+
 	// Unable to open the file
 	if ( fsfile == NULL )
 	{
@@ -457,7 +717,14 @@ wxBitmap TypeConv::StringToBitmap( const wxString& filename )
 	}
 
 	// Create a wxBitmap from the image
-	return wxBitmap( img );
+	wxBitmap bitmap( img );
+
+	if ( isLocal )
+	{
+		s_bitmapCache.Add( localFile, bitmap );
+	}
+
+	return bitmap;
 }
 
 void TypeConv::ParseBitmapWithResource( const wxString& value, wxString* image, wxString* source, wxSize* icoSize )
@@ -970,13 +1237,70 @@ wxString TypeConv::TextToString(const wxString &str)
 
 wxString TypeConv::StringToText(const wxString &str)
 {
+	return EscapeString( str, false );
+}
+
+namespace
+{
+	// Characters which have to be escaped, only ASCII ones need it
+	class EscapeTable
+	{
+	private:
+		bool m_escape[2][128];
+
+	public:
+		EscapeTable()
+		{
+			for ( int quotes = 0; quotes < 2; ++quotes )
+			{
+				for ( int c = 0; c < 128; ++c )
+				{
+					m_escape[quotes][c] = ( c == '\n' || c == '\t' || c == '\r' || c == '\\' || ( quotes && c == '"' ) );
+				}
+			}
+		}
+
+		const bool* Get( bool escapeQuotes ) const
+		{
+			return m_escape[ escapeQuotes ? 1 : 0 ];
+		}
+	};
+
+	const EscapeTable s_escapeTable;
+
+	inline const wxChar* FindEscape( const wxChar* p, const wxChar* end, const bool* table )
+	{
+		while ( p != end && ( (unsigned)*p >= 128 || !table[ (unsigned)*p ] ) )
+		{
+			++p;
+		}
+		return p;
+	}
+}
+
+wxString TypeConv::EscapeString( const wxString &str, bool escapeQuotes )
+{
+	const bool* table = s_escapeTable.Get( escapeQuotes );
+
+	const wxChar* begin = str.c_str();
+	const wxChar* end = begin + str.length();
+
+	// Most strings do not contain anything to escape
+	const wxChar* p = FindEscape( begin, end, table );
+	if ( p == end )
+	{
+		return str;
+	}
+
 	wxString result;
+	result.reserve( str.length() + str.length() / 8 + 2 );
 
-	for (unsigned int i=0 ; i < str.length() ; i++)
+	const wxChar* run = begin;
+	while ( p != end )
 	{
-		wxChar c = str[i];
+		result.append( run, p - run );
 
-		switch (c)
+		switch ( *p )
 		{
 		case wxT('\n'): result += wxT("\\n");
 			break;
@@ -990,11 +1314,16 @@ wxString TypeConv::StringToText(const wxString &str)
 		case wxT('\\'): result += wxT("\\\\");
 			break;
 
-		default:
-			result += c;
+		default: // '"'
+			result += wxT("\\\"");
 			break;
 		}
+
+		run = ++p;
+		p = FindEscape( p, end, table );
 	}
+	result.append( run, end - run );
+
 	return result;
 }
 
@@ -1038,7 +1367,7 @@ void MacroDictionary::Destroy()
 	s_instance = 0;
 }
 
-bool MacroDictionary::SearchMacro(wxString name, int *result)
+bool MacroDictionary::SearchMacro( const wxString& name, int *result )
 {
 	bool found = false;
 	MacroMap::iterator it = m_map.find(name);
@@ -1070,6 +1399,47 @@ bool MacroDictionary::SearchSynonymous(wxString synName, wxString& result)
 void MacroDictionary::AddMacro(wxString name, int value)
 {
 	m_map.insert(MacroMap::value_type(name,value));
+
+	// The cached bitlists could use the new macro
+	std::lock_guard< std::mutex > lock( m_bitlistsMutex );
+	m_bitlists.clear();
+}
+
+int MacroDictionary::GetBitlistValue( const wxString& bitlist )
+{
+	{
+		std::lock_guard< std::mutex > lock( m_bitlistsMutex );
+		MacroMap::iterator it = m_bitlists.find( bitlist );
+		if ( it != m_bitlists.end() )
+		{
+			return it->second;
+		}
+	}
+
+	int result = 0;
+	wxStringTokenizer tkz( bitlist, wxT("|") );
+	while ( tkz.HasMoreTokens() )
+	{
+		wxString token;
+		token = tkz.GetNextToken();
+		token.Trim( true );
+		token.Trim( false );
+
+		int value = 0;
+		SearchMacro( token, &value );
+		result |= value;
+	}
+
+	std::lock_guard< std::mutex > lock( m_bitlistsMutex );
+
+	// Keep it small if the values are edited a lot
+	if ( m_bitlists.size() >= 4096 )
+	{
+		m_bitlists.clear();
+	}
+	m_bitlists[ bitlist ] = result;
+
+	return result;
 }
 
 void MacroDictionary::AddSynonymous(wxString synName, wxString name)
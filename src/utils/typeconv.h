@@ -28,8 +28,10 @@
 
 #include <wx/wx.h>
 #include <wx/string.h>
+#include <wx/hashmap.h>
 #include <vector>
 #include <map>
+#include <mutex>
 #include "model/types.h"
 #include "fontcontainer.h"
 
@@ -62,6 +64,17 @@ namespace TypeConv
 
 	wxBitmap StringToBitmap( const wxString& filename );
 
+	// Releases the bitmaps kept by StringToBitmap, must be called before the GUI is shut down
+	void ClearBitmapCache();
+
+	// While enabled, StringToBitmap does not wait for image files that are not cached yet,
+	// it returns a placeholder and decodes them on a pool of threads (wxWidgets 2.9+ only)
+	void EnableBackgroundBitmaps( bool enable );
+
+	// Caches the images decoded in the background, must be called from the GUI thread.
+	// Returns true once all of them are ready, if any was added since the last time.
+	bool UpdateBackgroundBitmaps();
+
 	wxFontContainer StringToFont( const wxString &str );
 	wxString FontToString( const wxFontContainer &font );
 
@@ -103,6 +116,11 @@ namespace TypeConv
 	wxString StringToText( const wxString &str );
 	wxString TextToString( const wxString &str );
 
+	// Escapes '\n' '\t' '\r' '\\' and, if escapeQuotes is set, '"' C style.
+	// Copies the runs without special characters in bulk and returns the
+	// string unchanged when there is nothing to escape.
+	wxString EscapeString( const wxString &str, bool escapeQuotes );
+
 	double StringToFloat( const wxString& str );
 	wxString FloatToString( const double& val );
 };
@@ -114,10 +132,11 @@ namespace TypeConv
 class MacroDictionary;
 typedef MacroDictionary* PMacroDictionary;
 
+WX_DECLARE_STRING_HASH_MAP( int, MacroMap );
+
 class MacroDictionary
 {
 private:
-	typedef std::map<wxString, int> MacroMap;
 	static PMacroDictionary s_instance;
 
 	typedef std::map<wxString, wxString> SynMap;
@@ -125,13 +144,23 @@ private:
 	MacroMap m_map;
 	SynMap m_synMap;
 
+	// Value of each bitlist already computed, sizer flags and styles are read
+	// every time the designer is rebuilt and a project uses only a few of them
+	MacroMap m_bitlists;
+	std::mutex m_bitlistsMutex;
+
 	MacroDictionary();
 
 public:
 	static PMacroDictionary GetInstance();
 	static void Destroy();
-	bool SearchMacro( wxString name, int *result );
+	bool SearchMacro( const wxString& name, int *result );
 	void AddMacro( wxString name, int value );
+
+	/**
+	 * Value of a list of macros separated by '|', unknown macros count as 0.
+	 */
+	int GetBitlistValue( const wxString& bitlist );
 	void AddSynonymous( wxString synName, wxString name );
 	bool SearchSynonymous( wxString synName, wxString& result );
 };
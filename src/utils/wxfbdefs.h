@@ -40,6 +40,7 @@ class CodeInfo;
 class EventInfo;
 class Event;
 class PropertyCategory;
+class ObjectSnapshot;
 class wxFBManager;
 class CodeWriter;
 class TemplateParser;
@@ -62,6 +63,8 @@ typedef std::shared_ptr<PropertyInfo> PPropertyInfo;
 typedef std::shared_ptr<EventInfo>    PEventInfo;
 typedef std::shared_ptr<Event>        PEvent;
 typedef std::shared_ptr<PropertyCategory> PPropertyCategory;
+typedef std::shared_ptr<const ObjectSnapshot> PObjectSnapshot;
+typedef std::weak_ptr<const ObjectSnapshot>   WPObjectSnapshot;
 
 typedef std::map<wxString, PPropertyInfo> PropertyInfoMap;
 typedef std::map<wxString, PObjectInfo>   ObjectInfoMap;
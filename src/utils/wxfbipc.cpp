@@ -33,9 +33,20 @@
 
 #include "wxfbipc.h"
 #include <wx/filename.h>
+#include <wx/stdpaths.h>
+#include <wx/stopwatch.h>
 #include "utils/debug.h"
+#include "utils/wxlogstring.h"
+#include "utils/wxfbexception.h"
+#include "rad/appdata.h"
+#include <algorithm>
+#include <deque>
+#include <map>
 #include <utility>
 
+// Topic of the code generation connections
+static const wxChar* const s_generationTopic = wxT("wxFormBuilder-generate");
+
 bool wxFBIPC::VerifySingleInstance( const wxString& file, bool switchTo )
 {
 	// Possible send a message to the running instance through this string later, for now it is left empty
@@ -283,3 +294,273 @@ wxChar* AppConnection::OnRequest( const wxString& /*topic*/, const wxString& /*i
 	}
 }
 #endif
+
+wxFBGenerationIPC::wxFBGenerationIPC()
+{
+}
+
+wxFBGenerationIPC::~wxFBGenerationIPC()
+{
+}
+
+wxString wxFBGenerationIPC::GetDefaultService()
+{
+	wxString name = wxString::Format( wxT("wxFormBuilder-%s-codegen"), wxGetUserId().c_str() );
+
+	#ifdef __WXMSW__
+	return name;
+	#else
+	// A name that is not a port number makes wxTCPServer use a unix socket
+	return wxStandardPaths::Get().GetTempDir() + wxFILE_SEP_PATH + wxT(".") + name;
+	#endif
+}
+
+bool wxFBGenerationIPC::CreateServer( const wxString& service )
+{
+	std::unique_ptr< GenerationServer > server( new GenerationServer );
+	if ( !server->Create( service ) )
+	{
+		wxLogError( wxT("Failed to create an IPC service with name %s"), service.c_str() );
+		return false;
+	}
+
+	m_server = std::move(server);
+	return true;
+}
+
+bool wxFBGenerationIPC::Submit( const wxString& service, const wxString& file, const wxString& languages, wxString* reply, long timeout )
+{
+	wxFileName path( file );
+	if ( !path.IsOk() || !path.MakeAbsolute() )
+	{
+		wxLogError( wxT("This path is invalid: %s"), file.c_str() );
+		return false;
+	}
+
+	std::unique_ptr< GenerationClient > client( new GenerationClient );
+	std::unique_ptr< wxConnectionBase > connection;
+	{
+		#ifndef __WXFB_DEBUG__
+		wxLogNull stopLogging;
+		#endif
+		connection.reset( client->MakeConnection( wxT("localhost"), service, s_generationTopic ) );
+	}
+
+	if ( NULL == connection.get() )
+	{
+		wxLogError( _("Unable to connect to the code generation service %s"), service.c_str() );
+		return false;
+	}
+
+	wxString item = languages + wxT("\n") + path.GetFullPath();
+	wxString answer;
+
+	// The server answers QUEUED while it generates other requests, then the
+	// result has to be asked for until it is ready
+	wxStopWatch watch;
+	long wait = 50;
+	for ( ;; )
+	{
+	#if wxVERSION_NUMBER < 2900
+		wxChar* data = connection->Request( item, NULL );
+		answer = ( NULL != data ? wxString( data ) : wxString() );
+	#else
+		size_t size = 0;
+		const void* data = connection->Request( item, &size, wxIPC_UTF8TEXT );
+		answer = ( NULL != data ? wxString::FromUTF8( static_cast< const char* >( data ) ) : wxString() );
+	#endif
+
+		if ( !answer.StartsWith( wxT("QUEUED\n") ) )
+		{
+			break;
+		}
+
+		if ( watch.Time() > timeout )
+		{
+			connection->Disconnect();
+			wxLogError( _("The code generation service is still busy after %ld seconds."), timeout / 1000 );
+			return false;
+		}
+
+		item = wxT("RESULT\n") + answer.AfterFirst( wxT('\n') );
+		wxMilliSleep( wait );
+		wait = std::min( wait * 2, 1000L );
+	}
+
+	connection->Disconnect();
+
+	if ( answer.empty() )
+	{
+		wxLogError( _("The code generation service did not answer.") );
+		return false;
+	}
+
+	if ( NULL != reply )
+	{
+		*reply = answer.AfterFirst( wxT('\n') );
+	}
+
+	return answer.StartsWith( wxT("OK") );
+}
+
+namespace
+{
+	// Requests that arrive while another one is being generated, for instance while
+	// the log is flushed, wait here. The clients poll for their result with a
+	// RESULT request, which also generates the next queued request.
+	struct GenerationQueue
+	{
+		bool busy;
+		unsigned long nextTicket;
+		std::deque< std::pair< unsigned long, wxString > > pending;
+		std::map< unsigned long, wxString > results;
+
+		GenerationQueue() : busy( false ), nextTicket( 1 ) {}
+	};
+
+	GenerationQueue s_queue;
+
+	// Results nobody asked for, because the client went away, are dropped after a while
+	const size_t MAX_RESULTS = 64;
+
+	// Marks the server busy for the lifetime of the object, even if the generation throws
+	class BusyScope
+	{
+	public:
+		BusyScope() { s_queue.busy = true; }
+		~BusyScope() { s_queue.busy = false; }
+	};
+
+	wxString Queued( unsigned long ticket )
+	{
+		return wxString::Format( wxT("QUEUED\n%lu"), ticket );
+	}
+}
+
+wxString GenerationConnection::Run( const wxString& item )
+{
+	BusyScope busy;
+
+	wxString languages = item.BeforeFirst( wxT('\n') );
+	wxString file = item.AfterFirst( wxT('\n') );
+
+	wxStopWatch watch;
+
+	// Keep a copy of everything logged while generating, to send it back to the client
+	wxString log;
+	bool result = false;
+	{
+		// The chain deletes the string target when it goes out of scope
+		wxLogString* messages = new wxLogString;
+		wxLogChain chain( messages );
+		try
+		{
+			result = AppData()->GenerateCodeFiles( file, languages );
+		}
+		catch ( wxFBException& ex )
+		{
+			wxLogError( ex.what() );
+		}
+		wxLogMessage( _("%s handled in %ld ms."), file.c_str(), watch.Time() );
+		log = messages->GetStr();
+	}
+
+	return wxString( result ? wxT("OK") : wxT("FAILED") ) + wxT("\n") + log;
+}
+
+wxString GenerationConnection::Generate( const wxString& item )
+{
+	if ( item.BeforeFirst( wxT('\n') ) != wxT("RESULT") )
+	{
+		// A new request, generated at once if nothing is waiting
+		if ( !s_queue.busy && s_queue.pending.empty() )
+		{
+			return Run( item );
+		}
+
+		unsigned long ticket = s_queue.nextTicket++;
+		s_queue.pending.push_back( std::make_pair( ticket, item ) );
+		return Queued( ticket );
+	}
+
+	unsigned long ticket = 0;
+	if ( !item.AfterFirst( wxT('\n') ).ToULong( &ticket ) )
+	{
+		return wxT("FAILED\nInvalid request.\n");
+	}
+
+	// Generate the oldest waiting request, which may belong to another client
+	if ( !s_queue.busy && !s_queue.pending.empty() )
+	{
+		std::pair< unsigned long, wxString > next = s_queue.pending.front();
+		s_queue.pending.pop_front();
+
+		wxString reply = Run( next.second );
+		if ( next.first == ticket )
+		{
+			return reply;
+		}
+
+		if ( s_queue.results.size() >= MAX_RESULTS )
+		{
+			s_queue.results.erase( s_queue.results.begin() );
+		}
+		s_queue.results[ next.first ] = reply;
+	}
+
+	std::map< unsigned long, wxString >::iterator result = s_queue.results.find( ticket );
+	if ( result != s_queue.results.end() )
+	{
+		wxString reply = result->second;
+		s_queue.results.erase( result );
+		return reply;
+	}
+
+	for ( size_t i = 0; i < s_queue.pending.size(); ++i )
+	{
+		if ( s_queue.pending[i].first == ticket )
+		{
+			return Queued( ticket );
+		}
+	}
+
+	return wxT("FAILED\nThe request was lost by the code generation service.\n");
+}
+
+#if wxVERSION_NUMBER < 2900
+wxChar* GenerationConnection::OnRequest( const wxString& /*topic*/, const wxString& item, int* size, wxIPCFormat /*format*/ )
+{
+	m_data = Generate( item );
+	if ( NULL != size )
+	{
+		*size = ( m_data.length() + 1 ) * sizeof(wxChar);
+	}
+	return const_cast< wxChar* >( m_data.c_str() );
+}
+#else
+const void* GenerationConnection::OnRequest( const wxString& /*topic*/, const wxString& item, size_t* size, wxIPCFormat /*format*/ )
+{
+	m_data = Generate( item );
+	m_buffer = m_data.utf8_str();
+	if ( NULL != size )
+	{
+		*size = m_buffer.length() + 1;
+	}
+	return m_buffer.data();
+}
+#endif
+
+wxConnectionBase* GenerationServer::OnAcceptConnection( const wxString& topic )
+{
+	if ( topic != s_generationTopic )
+	{
+		return NULL;
+	}
+
+	return new GenerationConnection;
+}
+
+wxConnectionBase* GenerationClient::OnMakeConnection()
+{
+	return new GenerationConnection;
+}
@@ -85,4 +85,69 @@ public:
 	wxConnectionBase* OnMakeConnection();
 };
 
+/* Code generation service, so build tools can use a process that has already loaded the plugins */
+
+class GenerationServer;
+
+class wxFBGenerationIPC
+{
+	private:
+		std::unique_ptr< GenerationServer > m_server;
+
+	public:
+		wxFBGenerationIPC();
+		~wxFBGenerationIPC();
+
+		/**
+		 * Local service name used when none is given.
+		 * A DDE service in Windows, a unix socket in the temporary directory otherwise.
+		 */
+		static wxString GetDefaultService();
+
+		bool CreateServer( const wxString& service );
+
+		/**
+		 * Asks the server to generate the code of a project, waiting while it is busy with other requests.
+		 * @param reply Timings and messages logged by the server.
+		 * @param timeout Milliseconds to wait for a busy server before giving up.
+		 * @return false if the server is unreachable, busy for too long or the generation failed.
+		 */
+		static bool Submit( const wxString& service, const wxString& file, const wxString& languages, wxString* reply, long timeout = 600000 );
+};
+
+// Each request generates the code of one project
+class GenerationConnection: public wxConnection
+{
+private:
+	wxString m_data;
+#if wxVERSION_NUMBER >= 2900
+	wxCharBuffer m_buffer;
+#endif
+
+	wxString Generate( const wxString& item );
+	wxString Run( const wxString& item );
+
+public:
+	GenerationConnection(){}
+	~GenerationConnection(){}
+
+#if wxVERSION_NUMBER < 2900
+	wxChar* OnRequest( const wxString& topic, const wxString& item, int* size, wxIPCFormat format );
+#else
+	const void* OnRequest( const wxString& topic, const wxString& item, size_t* size, wxIPCFormat format );
+#endif
+};
+
+class GenerationServer: public wxServer
+{
+public:
+	wxConnectionBase* OnAcceptConnection( const wxString& topic );
+};
+
+class GenerationClient: public wxClient
+{
+public:
+	wxConnectionBase* OnMakeConnection();
+};
+
 #endif //WXFBIPC_H
@@ -31,11 +31,19 @@ private:
 public:
     wxLogString(){}
 
+#if wxVERSION_NUMBER < 2900
     void DoLogString( const wxChar* str, time_t t )
 	{
 		m_str += str;
 		m_str += wxT("\n");
 	}
+#else
+    void DoLogText( const wxString& msg )
+	{
+		m_str += msg;
+		m_str += wxT("\n");
+	}
+#endif
 
     void FlushStr( wxString& str )
     {